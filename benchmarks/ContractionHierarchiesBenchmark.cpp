@@ -0,0 +1,165 @@
+// ContractionHierarchiesBenchmark.cpp
+//
+//
+// Compares point-to-point query time of ContractionHierarchies against
+// Digraph::findShortestPaths() and Digraph::aStar() on the same grid
+// "road network", and checks that all three agree on the distances.  The
+// hierarchy is queried after a round trip through save() and load(), and
+// every path() it returns is checked to follow edges of the grid and add
+// up to the distance.
+//
+// Build from the repository root with something like:
+//
+//     g++ -std=c++17 -O2 -IdataStructures
+//         benchmarks/ContractionHierarchiesBenchmark.cpp -o chBenchmark
+//
+// and run as "chBenchmark [side] [queries]".
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "ContractionHierarchies.hpp"
+
+
+struct Point
+{
+    double x;
+    double y;
+};
+
+
+namespace
+{
+    double elapsedMicros(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+
+    double pathLength(const Digraph<Point, double>& g, const std::vector<int>& path)
+    {
+        double length = 0.0;
+        for(int i = 0; i + 1 < static_cast<int>(path.size()); i++)
+            length += g.edgeInfo(path[i], path[i + 1]);
+        return length;
+    }
+
+
+    // isShortestPath() returns true if path runs from one vertex to the
+    // other along edges of g and its length is the given distance.
+    bool isShortestPath(const Digraph<Point, double>& g, const std::vector<int>& path,
+                        int fromVertex, int toVertex, double distance)
+    {
+        if(path.empty() || path.front() != fromVertex || path.back() != toVertex)
+            return false;
+        try
+        {
+            return std::abs(pathLength(g, path) - distance) <= 1e-6;
+        }
+        catch(const DigraphException&)
+        {
+            return false;
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 50;
+    int queries = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<double> stretch{1.0, 1.5};
+
+    Digraph<Point, double> g;
+    for(int r = 0; r < side; r++)
+        for(int c = 0; c < side; c++)
+            g.addVertex(r * side + c, Point{double(r), double(c)});
+
+    for(int r = 0; r < side; r++)
+    {
+        for(int c = 0; c < side; c++)
+        {
+            int v = r * side + c;
+            if(r + 1 < side)
+            {
+                g.addEdge(v, v + side, stretch(rng));
+                g.addEdge(v + side, v, stretch(rng));
+            }
+            if(c + 1 < side)
+            {
+                g.addEdge(v, v + 1, stretch(rng));
+                g.addEdge(v + 1, v, stretch(rng));
+            }
+        }
+    }
+
+    auto weight = [](const double& e) { return e; };
+    auto heuristic = [](const Point& a, const Point& b)
+    {
+        return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    ContractionHierarchies built{g, weight};
+    double preprocess = elapsedMicros(start);
+
+    std::stringstream stored;
+    built.save(stored);
+    ContractionHierarchies ch = ContractionHierarchies::load(stored);
+
+    std::uniform_int_distribution<int> pick{0, side * side - 1};
+    std::vector<std::pair<int,int>> pairs;
+    for(int i = 0; i < queries; i++)
+        pairs.push_back({pick(rng), pick(rng)});
+
+    std::vector<double> chDistances;
+    start = std::chrono::steady_clock::now();
+    for(const auto& p : pairs)
+        chDistances.push_back(ch.distance(p.first, p.second));
+    double chTime = elapsedMicros(start);
+
+    std::vector<double> aStarDistances;
+    start = std::chrono::steady_clock::now();
+    for(const auto& p : pairs)
+        aStarDistances.push_back(pathLength(g, g.aStar(p.first, p.second, weight, heuristic)));
+    double aStarTime = elapsedMicros(start);
+
+    int mismatches = 0;
+    for(int i = 0; i < queries; i++)
+    {
+        if(!isShortestPath(g, ch.path(pairs[i].first, pairs[i].second),
+                           pairs[i].first, pairs[i].second, chDistances[i]))
+            mismatches++;
+    }
+
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < queries; i++)
+    {
+        std::map<int,int> pred = g.findShortestPaths(pairs[i].first, weight);
+        double d = 0.0;
+        for(int v = pairs[i].second; v != pairs[i].first; v = pred[v])
+            d += g.edgeInfo(pred[v], v);
+        if(std::abs(d - chDistances[i]) > 1e-6 || std::abs(d - aStarDistances[i]) > 1e-6)
+            mismatches++;
+    }
+    double dijkstraTime = elapsedMicros(start);
+
+    std::cout << "vertices:          " << g.vertexCount() << '\n'
+              << "edges:             " << g.edgeCount() << '\n'
+              << "ch arcs:           " << ch.arcCount() << '\n'
+              << "ch file:           " << stored.str().size() << " bytes\n"
+              << "ch preprocessing:  " << preprocess / 1000.0 << " ms\n"
+              << "ch query:          " << chTime / queries << " us\n"
+              << "aStar query:       " << aStarTime / queries << " us\n"
+              << "dijkstra query:    " << dijkstraTime / queries << " us\n"
+              << "mismatches:        " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
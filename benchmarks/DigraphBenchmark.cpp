@@ -0,0 +1,387 @@
+// DigraphBenchmark.cpp
+//
+//
+// A benchmark suite for Digraph and the snapshot-based algorithms, on
+// synthetic graphs from GraphGenerators.hpp: an R-MAT ("Kronecker")
+// graph, a grid "road network" and an Erdos-Renyi random graph.
+//
+// For each graph it times building a Digraph with addEdge(), copying the
+// edges out with edges(), isStronglyConnected() and findShortestPaths(),
+// then snapshots the graph and times the multi-threaded algorithms
+// (deltaStepping(), breadthFirstSearch(), weaklyConnectedComponents()
+// and pageRank()) at 1, 2, 4, ... threads up to the number of hardware
+// threads.  Every measurement is repeated and the median kept; it is
+// reported with its throughput (edges processed per second) and, for the
+// steps that build something, the memory it takes, counted exactly by
+// replacing the global operator new and operator delete.  Searches start
+// from the vertex with the most outgoing edges.
+//
+// isStronglyConnected() runs a search from every vertex, so it is timed
+// on a much smaller graph from the same generator (the "small" rows),
+// cut down to its largest strongly connected component so that the
+// answer is "yes" and every search has to run to the end.
+//
+// Build from the repository root with something like:
+//
+//     g++ -std=c++17 -O2 -IdataStructures
+//         benchmarks/DigraphBenchmark.cpp -o digraphBenchmark -pthread
+//
+// and run as "digraphBenchmark [rmat|grid|er|all] [scale] [repetitions]
+// [--csv]", where the graphs have about 2^scale vertices (scale being 5
+// to 30) and, apart from the grid, 16 edges per vertex.  With --csv, the
+// results are printed as comma-separated values, ready to compare against
+// an earlier run.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "BreadthFirstSearch.hpp"
+#include "CSRGraph.hpp"
+#include "ConnectedComponents.hpp"
+#include "DeltaStepping.hpp"
+#include "Digraph.hpp"
+#include "GraphGenerators.hpp"
+#include "PageRank.hpp"
+
+
+namespace
+{
+    typedef std::vector<std::pair<int, int>> EdgeList;
+
+    bool csv = false;
+
+    // the number of bytes currently allocated with operator new
+    std::atomic<long long> heapBytes{0};
+
+    // every allocation is prefixed with its size, padded to keep the
+    // alignment operator new promises
+    constexpr std::size_t PREFIX = alignof(std::max_align_t);
+
+
+    void* allocate(std::size_t size)
+    {
+        void* block = std::malloc(size + PREFIX);
+        if(block == nullptr)
+            throw std::bad_alloc{};
+        *static_cast<std::size_t*>(block) = size;
+        heapBytes.fetch_add(size, std::memory_order_relaxed);
+        return static_cast<char*>(block) + PREFIX;
+    }
+
+
+    void deallocate(void* p) noexcept
+    {
+        if(p == nullptr)
+            return;
+        void* block = static_cast<char*>(p) - PREFIX;
+        heapBytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+
+
+    double elapsedMillis(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+
+    long long allocatedBytes()
+    {
+        return heapBytes.load(std::memory_order_relaxed);
+    }
+
+
+    // median() runs func the given number of times (at least once) and
+    // returns the median time taken, in milliseconds.
+    template <typename Func>
+    double median(int repetitions, Func func)
+    {
+        std::vector<double> times;
+        for(int i = 0; i < std::max(repetitions, 1); i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            times.push_back(elapsedMillis(start));
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+
+    void printHeader()
+    {
+        if(csv)
+            std::cout << "graph,benchmark,threads,millis,edgesPerSecond,memoryBytes\n";
+        else
+            std::cout << std::left << std::setw(12) << "graph" << std::setw(28) << "benchmark"
+                      << std::right << std::setw(8) << "threads" << std::setw(12) << "ms"
+                      << std::setw(16) << "edges/s" << std::setw(12) << "memory MB" << "\n";
+    }
+
+
+    // report() prints one result; memory is -1 when not measured.
+    void report(const std::string& graph, const std::string& benchmark, unsigned int threads,
+                double millis, long long edges, long long memory = -1)
+    {
+        double rate = millis > 0.0 ? edges / (millis / 1000.0) : 0.0;
+        if(csv)
+        {
+            std::cout << graph << "," << benchmark << "," << threads << "," << millis << ","
+                      << rate << "," << memory << "\n";
+            return;
+        }
+
+        std::cout << std::left << std::setw(12) << graph << std::setw(28) << benchmark
+                  << std::right << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(2) << millis
+                  << std::setw(16) << std::setprecision(0) << rate;
+        if(memory >= 0)
+            std::cout << std::setw(12) << std::setprecision(1) << memory / (1024.0 * 1024.0);
+        else
+            std::cout << std::setw(12) << "-";
+        std::cout << "\n";
+    }
+
+
+    // build() makes a Digraph of vertices 0 to n - 1 with the given edges,
+    // each weighted between 1 and 100.
+    Digraph<int, double> build(int n, const EdgeList& edges)
+    {
+        std::mt19937 rng{7};
+        std::uniform_real_distribution<double> weight{1.0, 100.0};
+
+        Digraph<int, double> d;
+        for(int v = 0; v < n; v++)
+            d.addVertex(v, v);
+        for(const std::pair<int, int>& e : edges)
+            d.addEdge(e.first, e.second, weight(rng));
+        return d;
+    }
+
+
+    // strongPart() returns the edges of the strongly connected component
+    // holding the vertex with the most outgoing edges, which in these
+    // graphs is the largest one, with its vertices renumbered from 0 to
+    // n - 1; n is set to how many there are.
+    EdgeList strongPart(int& n, const EdgeList& edges)
+    {
+        CSRGraph g{build(n, edges)};
+        CSRGraph transposed = g.transpose();
+
+        int start = 0;
+        for(int v = 0; v < n; v++)
+            if(g.outDegree(v) > g.outDegree(start))
+                start = v;
+
+        // the component is whatever start both reaches and is reached from
+        BFSTree forward = breadthFirstSearch(g, transposed, start, 1);
+        BFSTree backward = breadthFirstSearch(transposed, g, start, 1);
+        std::vector<int> renumbered(n, -1);
+        int count = 0;
+        for(int v = 0; v < n; v++)
+            if(forward.level[v] >= 0 && backward.level[v] >= 0)
+                renumbered[v] = count++;
+
+        EdgeList part;
+        for(const std::pair<int, int>& e : edges)
+            if(renumbered[e.first] >= 0 && renumbered[e.second] >= 0)
+                part.emplace_back(renumbered[e.first], renumbered[e.second]);
+        n = count;
+        return part;
+    }
+
+
+    std::vector<unsigned int> threadCounts()
+    {
+        unsigned int hardware = resolveThreadCount(0);
+        std::vector<unsigned int> counts;
+        for(unsigned int t = 1; t < hardware; t *= 2)
+            counts.push_back(t);
+        counts.push_back(hardware);
+        return counts;
+    }
+
+
+    void run(const std::string& name, int n, const EdgeList& edges,
+             int smallN, const EdgeList& smallEdges, int repetitions)
+    {
+        long long m = edges.size();
+        auto weight = [](const double& e) { return e; };
+
+        // building is timed once, since it is what takes the memory
+        long long before = allocatedBytes();
+        auto clock = std::chrono::steady_clock::now();
+        Digraph<int, double> d = build(n, edges);
+        double buildTime = elapsedMillis(clock);
+        report(name, "addEdge", 1, buildTime, m, allocatedBytes() - before);
+
+        report(name, "edges()", 1, median(repetitions, [&]
+        {
+            std::vector<std::pair<int, int>> copy = d.edges();
+            if(copy.size() != edges.size())
+                std::abort();
+        }), m);
+
+        int strongN = smallN;
+        EdgeList strongEdges = strongPart(strongN, smallEdges);
+        Digraph<int, double> small = build(strongN, strongEdges);
+        report(name + "/small", "isStronglyConnected()", 1, median(repetitions, [&]
+        {
+            if(!small.isStronglyConnected())
+                std::abort();
+        }), static_cast<long long>(strongEdges.size()) * strongN);
+
+        int start = 0;
+        for(int v : d.vertexView())
+            if(d.edgeCount(v) > d.edgeCount(start))
+                start = v;
+
+        report(name, "findShortestPaths()", 1, median(repetitions, [&]
+        {
+            d.findShortestPaths(start, weight);
+        }), m);
+
+        before = allocatedBytes();
+        clock = std::chrono::steady_clock::now();
+        CSRGraph g{d, weight};
+        CSRGraph transposed = g.transpose();
+        report(name, "CSRGraph + transpose", 1, elapsedMillis(clock), m, allocatedBytes() - before);
+
+        for(unsigned int threads : threadCounts())
+        {
+            report(name, "deltaStepping()", threads, median(repetitions, [&]
+            {
+                deltaStepping(g, start, 0.0, threads);
+            }), m);
+            report(name, "breadthFirstSearch()", threads, median(repetitions, [&]
+            {
+                breadthFirstSearch(g, transposed, start, threads);
+            }), m);
+            report(name, "weaklyConnectedComponents()", threads, median(repetitions, [&]
+            {
+                weaklyConnectedComponents(g, threads);
+            }), m);
+
+            // pageRank() is timed for a fixed 20 iterations, so that the
+            // throughput counts every edge once per iteration
+            report(name, "pageRank() x20", threads, median(repetitions, [&]
+            {
+                pageRank(g, transposed, 0.85, 0.0, 20, threads);
+            }), 20 * m);
+        }
+    }
+}
+
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    deallocate(p);
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args;
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else
+            args.push_back(argv[i]);
+    }
+
+    std::string which = args.size() > 0 ? args[0] : "all";
+    int scale = args.size() > 1 ? std::atoi(args[1].c_str()) : 16;
+    int repetitions = args.size() > 2 ? std::atoi(args[2].c_str()) : 3;
+    int smallScale = std::min(scale, 8);
+
+    if(which != "rmat" && which != "grid" && which != "er" && which != "all")
+    {
+        std::cerr << "unknown graph \"" << which << "\", expected rmat, grid, er or all\n";
+        return 2;
+    }
+    // below scale 5, there aren't 16 distinct edges per vertex to pick,
+    // and above 30 the vertex numbers don't fit in an int
+    if(scale < 5 || scale > 30)
+    {
+        std::cerr << "scale must be between 5 and 30\n";
+        return 2;
+    }
+    if(repetitions < 1)
+    {
+        std::cerr << "repetitions must be at least 1\n";
+        return 2;
+    }
+
+    try
+    {
+        printHeader();
+
+        if(which == "rmat" || which == "all")
+        {
+            run("rmat", 1 << scale, rmatEdges(scale, 16LL << scale),
+                1 << smallScale, rmatEdges(smallScale, 16LL << smallScale), repetitions);
+        }
+        if(which == "grid" || which == "all")
+        {
+            int side = 1 << (scale / 2);
+            int smallSide = 1 << (smallScale / 2);
+            run("grid", side * side, gridEdges(side, side),
+                smallSide * smallSide, gridEdges(smallSide, smallSide), repetitions);
+        }
+        if(which == "er" || which == "all")
+        {
+            run("er", 1 << scale, erdosRenyiEdges(1 << scale, 16LL << scale),
+                1 << smallScale, erdosRenyiEdges(1 << smallScale, 16LL << smallScale), repetitions);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
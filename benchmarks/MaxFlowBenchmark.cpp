@@ -0,0 +1,168 @@
+// MaxFlowBenchmark.cpp
+//
+//
+// Compares maxFlowPushRelabel() against maxFlowDinic() on the same
+// network, and checks that they agree on the flow value.  The network is
+// either read from a DIMACS maximum flow (".max") file or, by default,
+// generated: a stack of square grids ("frames") in the style of the
+// GENRMF generator, where each frame is strongly connected by edges of
+// large capacity and consecutive frames are joined by edges of small
+// random capacity, with the source and sink in the first and last frame.
+//
+// Build from the repository root with something like:
+//
+//     g++ -std=c++17 -O2 -IdataStructures
+//         benchmarks/MaxFlowBenchmark.cpp -o maxFlowBenchmark -pthread
+//
+// and run as "maxFlowBenchmark [side] [frames]" or
+// "maxFlowBenchmark file.max".
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "DigraphBuilder.hpp"
+#include "MaxFlow.hpp"
+
+
+namespace
+{
+    double elapsedMillis(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+
+    Digraph<int, double> generate(int side, int frames, int& source, int& sink)
+    {
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<int> small{1, 100};
+        int large = 100 * side * side;
+
+        DigraphBuilder<int, double> builder;
+        auto id = [&](int f, int r, int c) { return (f * side + r) * side + c + 1; };
+        for(int f = 0; f < frames; f++)
+        {
+            std::vector<int> order(side * side);
+            for(int i = 0; i < side * side; i++)
+                order[i] = i;
+            std::shuffle(order.begin(), order.end(), rng);
+
+            for(int r = 0; r < side; r++)
+            {
+                for(int c = 0; c < side; c++)
+                {
+                    builder.addVertex(id(f, r, c), 0);
+                    if(r + 1 < side)
+                    {
+                        builder.addEdge(id(f, r, c), id(f, r + 1, c), large);
+                        builder.addEdge(id(f, r + 1, c), id(f, r, c), large);
+                    }
+                    if(c + 1 < side)
+                    {
+                        builder.addEdge(id(f, r, c), id(f, r, c + 1), large);
+                        builder.addEdge(id(f, r, c + 1), id(f, r, c), large);
+                    }
+                    if(f + 1 < frames)
+                    {
+                        int k = order[r * side + c];
+                        builder.addEdge(id(f, r, c), id(f + 1, k / side, k % side), small(rng));
+                    }
+                }
+            }
+        }
+
+        source = id(0, 0, 0);
+        sink = id(frames - 1, side - 1, side - 1);
+        return builder.build();
+    }
+
+
+    // load() reads a DIMACS maximum flow file.  Parallel arcs are merged
+    // into one edge carrying their total capacity, which has the same
+    // maximum flow.
+    Digraph<int, double> load(const std::string& path, int& source, int& sink)
+    {
+        std::ifstream file{path};
+        if(!file)
+            throw DigraphException{std::string("When MaxFlowBenchmark, can't open file!")};
+
+        std::string line;
+        long long vertices = -1;
+        source = sink = -1;
+        std::map<std::pair<int, int>, double> capacities;
+        while(std::getline(file, line))
+        {
+            std::istringstream words{line};
+            std::string kind;
+            if(!(words >> kind) || kind == "c")
+                continue;
+
+            std::string problem, which;
+            long long arcs;
+            int from, to, vertex;
+            double capacity;
+            if(kind == "p" && words >> problem >> vertices >> arcs)
+                continue;
+            else if(kind == "n" && words >> vertex >> which)
+                (which == "s" ? source : sink) = vertex;
+            else if(kind == "a" && words >> from >> to >> capacity)
+                capacities[{from, to}] += capacity;
+            else
+                throw DigraphException{std::string("When MaxFlowBenchmark, bad line: ") + line};
+        }
+        if(vertices < 0)
+            throw DigraphException{std::string("When MaxFlowBenchmark, no problem line!")};
+        if(source == -1 || sink == -1)
+            throw DigraphException{std::string("When MaxFlowBenchmark, no source or sink!")};
+
+        DigraphBuilder<int, double> builder;
+        builder.reserve(vertices, capacities.size());
+        for(long long v = 1; v <= vertices; v++)
+            builder.addVertex(static_cast<int>(v), 0);
+        for(const auto& arc : capacities)
+            builder.addEdge(arc.first.first, arc.first.second, arc.second);
+        return builder.build();
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    int source, sink;
+    Digraph<int, double> g;
+    if(argc > 1 && std::string(argv[1]).find_first_not_of("0123456789") != std::string::npos)
+        g = load(argv[1], source, sink);
+    else
+        g = generate(argc > 1 ? std::atoi(argv[1]) : 30, argc > 2 ? std::atoi(argv[2]) : 30, source, sink);
+
+    auto capacity = [](const double& c) { return c; };
+
+    auto start = std::chrono::steady_clock::now();
+    MaxFlowResult pushRelabel = maxFlowPushRelabel(g, source, sink, capacity);
+    double pushRelabelTime = elapsedMillis(start);
+
+    start = std::chrono::steady_clock::now();
+    MaxFlowResult dinic = maxFlowDinic(g, source, sink, capacity);
+    double dinicTime = elapsedMillis(start);
+
+    bool agree = std::abs(pushRelabel.value - dinic.value) <= 1e-9 * std::max(1.0, dinic.value);
+
+    std::cout << "vertices:          " << g.vertexCount() << '\n'
+              << "edges:             " << g.edgeCount() << '\n'
+              << "flow value:        " << dinic.value << '\n'
+              << "cut edges:         " << dinic.cutEdges.size() << '\n'
+              << "push-relabel:      " << pushRelabelTime << " ms\n"
+              << "dinic:             " << dinicTime << " ms\n"
+              << "agree:             " << (agree ? "yes" : "no") << std::endl;
+
+    return agree ? 0 : 1;
+}
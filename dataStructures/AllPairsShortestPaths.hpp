@@ -0,0 +1,377 @@
+// AllPairsShortestPaths.hpp
+//
+//
+// Shortest path distances from many sources at once over a weighted
+// CSRGraph snapshot, collected into a DistanceMatrix:
+//
+//   * multiSourceShortestPaths() runs Dijkstra's algorithm from each of
+//     a list of sources, spreading the sources over threads.  Each thread
+//     keeps its distance array and heap from one source to the next and
+//     resets only the entries the last search touched, so a search costs
+//     time in proportion to what it reaches rather than to the whole graph.
+//
+//   * floydWarshall() computes all pairs at once in a blocked ("tiled")
+//     form: the matrix is processed in square tiles small enough to stay
+//     in cache, and within each round all of the independent tiles are
+//     updated in parallel.  It suits small, dense graphs and allows
+//     negative edge weights.
+//
+//   * johnson() also allows negative edge weights: a Bellman-Ford pass
+//     finds vertex potentials that make every weight non-negative, after
+//     which multiSourceShortestPaths() is run from every vertex.  It
+//     suits large, sparse graphs.
+//
+// Rows and columns of a DistanceMatrix are dense vertex indices of the
+// snapshot (rows being the sources in the order given), and a vertex that
+// can't be reached has an infinite distance.
+//
+
+#ifndef ALLPAIRSSHORTESTPATHS_HPP
+#define ALLPAIRSSHORTESTPATHS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// A DistanceMatrix is a dense rows-by-columns matrix of distances, stored
+// one row after another.
+
+class DistanceMatrix
+{
+public:
+    // Initializes an empty DistanceMatrix with no rows and no columns.
+    DistanceMatrix();
+
+    // Initializes a DistanceMatrix of the given size with every entry
+    // set to the given value.
+    DistanceMatrix(int rows, int columns, double value);
+
+    int rows() const noexcept;
+    int columns() const noexcept;
+
+    // These return the entry in the given row and column.
+    double& operator()(int row, int column);
+    double operator()(int row, int column) const;
+
+    // row() returns a pointer to the first of the given row's entries.
+    double* row(int row);
+    const double* row(int row) const;
+
+private:
+    int rowCount;
+    int columnCount;
+    std::vector<double> values;
+};
+
+
+// multiSourceShortestPaths() computes the distances from each of the
+// given source vertices (by vertex number) to every vertex of a weighted
+// CSRGraph, one row per source.  A thread count of zero uses one per
+// hardware thread.  If the snapshot has no weights, has a negative
+// weight, or doesn't contain a source, a DigraphException is thrown
+// instead.
+DistanceMatrix multiSourceShortestPaths(
+    const CSRGraph& g, const std::vector<int>& sources, unsigned int threads = 0);
+
+
+// floydWarshall() computes the distance between every pair of vertices of
+// a weighted CSRGraph.  If the snapshot has no weights or has a cycle of
+// negative weight, a DigraphException is thrown instead.
+DistanceMatrix floydWarshall(const CSRGraph& g, unsigned int threads = 0);
+
+
+// johnson() computes the distance between every pair of vertices of a
+// weighted CSRGraph.  If the snapshot has no weights or has a cycle of
+// negative weight, a DigraphException is thrown instead.
+DistanceMatrix johnson(const CSRGraph& g, unsigned int threads = 0);
+
+
+
+inline DistanceMatrix::DistanceMatrix()
+    : rowCount{0}, columnCount{0}
+{
+}
+
+
+inline DistanceMatrix::DistanceMatrix(int rows, int columns, double value)
+    : rowCount{rows}, columnCount{columns},
+      values(static_cast<std::size_t>(rows) * columns, value)
+{
+}
+
+
+inline int DistanceMatrix::rows() const noexcept
+{
+    return rowCount;
+}
+
+
+inline int DistanceMatrix::columns() const noexcept
+{
+    return columnCount;
+}
+
+
+inline double& DistanceMatrix::operator()(int row, int column)
+{
+    return values[static_cast<std::size_t>(row) * columnCount + column];
+}
+
+
+inline double DistanceMatrix::operator()(int row, int column) const
+{
+    return values[static_cast<std::size_t>(row) * columnCount + column];
+}
+
+
+inline double* DistanceMatrix::row(int row)
+{
+    return values.data() + static_cast<std::size_t>(row) * columnCount;
+}
+
+
+inline const double* DistanceMatrix::row(int row) const
+{
+    return values.data() + static_cast<std::size_t>(row) * columnCount;
+}
+
+
+
+namespace impl_
+{
+    // the side of the square tiles floydWarshall() works on; three tiles
+    // of doubles (the one being updated and the two it reads) fit in L2
+    constexpr int AllPairsShortestPaths__TILE = 64;
+
+
+    // AllPairsShortestPaths__Scratch is the per-thread state of
+    // multiSourceShortestPaths(), reused from one source to the next.
+    struct AllPairsShortestPaths__Scratch
+    {
+        std::vector<double> distance;
+        std::vector<int> touched;
+        std::vector<std::pair<double, int>> heap;
+    };
+
+
+    inline void AllPairsShortestPaths__dijkstra(
+        const CSRGraph& g, int source, AllPairsShortestPaths__Scratch& scratch, double* row)
+    {
+        const CSRArray<int>& offsets = g.offsets();
+        const CSRArray<int>& targets = g.targets();
+        const CSRArray<double>& weights = g.weights();
+        std::vector<double>& dist = scratch.distance;
+        std::vector<std::pair<double, int>>& heap = scratch.heap;
+        std::greater<std::pair<double, int>> later;
+
+        dist[source] = 0.0;
+        scratch.touched.push_back(source);
+        heap.push_back(std::pair<double, int>{0.0, source});
+        while(!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            std::pair<double, int> top = heap.back();
+            heap.pop_back();
+            if(top.first > dist[top.second])
+                continue;
+
+            int v = top.second;
+            for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                int w = targets[i];
+                double candidate = top.first + weights[i];
+                if(candidate < dist[w])
+                {
+                    if(dist[w] == std::numeric_limits<double>::infinity())
+                        scratch.touched.push_back(w);
+                    dist[w] = candidate;
+                    heap.push_back(std::pair<double, int>{candidate, w});
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+
+        // copy out what was reached, and leave the scratch clean for next time
+        for(int v : scratch.touched)
+        {
+            row[v] = dist[v];
+            dist[v] = std::numeric_limits<double>::infinity();
+        }
+        scratch.touched.clear();
+    }
+
+
+    // AllPairsShortestPaths__tile() updates the tile of m with rows
+    // [i0, i1) and columns [j0, j1) through the vertices [k0, k1).
+    inline void AllPairsShortestPaths__tile(
+        DistanceMatrix& m, int i0, int i1, int j0, int j1, int k0, int k1)
+    {
+        for(int k = k0; k < k1; k++)
+        {
+            const double* rowK = m.row(k);
+            for(int i = i0; i < i1; i++)
+            {
+                double* rowI = m.row(i);
+                double dik = rowI[k];
+                if(dik == std::numeric_limits<double>::infinity())
+                    continue;
+                for(int j = j0; j < j1; j++)
+                    rowI[j] = std::min(rowI[j], dik + rowK[j]);
+            }
+        }
+    }
+}
+
+
+inline DistanceMatrix multiSourceShortestPaths(
+    const CSRGraph& g, const std::vector<int>& sources, unsigned int threads)
+{
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When multiSourceShortestPaths, graph has no weights!")};
+    for(double w : g.weights())
+        if(w < 0.0)
+            throw DigraphException{std::string("When multiSourceShortestPaths, negative edge weight!")};
+
+    int n = g.vertexCount();
+    std::vector<int> sourceIndices(sources.size());
+    for(std::size_t s = 0; s < sources.size(); s++)
+        sourceIndices[s] = g.indexOf(sources[s]);
+
+    DistanceMatrix m(sources.size(), n, std::numeric_limits<double>::infinity());
+    threads = std::min<std::size_t>(resolveThreadCount(threads), std::max<std::size_t>(sources.size(), 1));
+
+    // sources are handed out round-robin, which balances the work better
+    // than contiguous blocks when nearby sources reach similar amounts
+    runThreads(threads, [&](unsigned int t)
+    {
+        impl_::AllPairsShortestPaths__Scratch scratch;
+        scratch.distance.assign(n, std::numeric_limits<double>::infinity());
+        for(std::size_t s = t; s < sourceIndices.size(); s += threads)
+            impl_::AllPairsShortestPaths__dijkstra(g, sourceIndices[s], scratch, m.row(s));
+    });
+
+    return m;
+}
+
+
+inline DistanceMatrix floydWarshall(const CSRGraph& g, unsigned int threads)
+{
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When floydWarshall, graph has no weights!")};
+
+    int n = g.vertexCount();
+    DistanceMatrix m(n, n, std::numeric_limits<double>::infinity());
+    for(int v = 0; v < n; v++)
+    {
+        m(v, v) = 0.0;
+        for(int i = g.offsets()[v]; i < g.offsets()[v + 1]; i++)
+        {
+            double& entry = m(v, g.targets()[i]);
+            entry = std::min(entry, g.weights()[i]);
+        }
+    }
+
+    const int TILE = impl_::AllPairsShortestPaths__TILE;
+    int tiles = (n + TILE - 1) / TILE;
+    auto lo = [&](int t) { return t * TILE; };
+    auto hi = [&](int t) { return std::min(n, (t + 1) * TILE); };
+
+    for(int k = 0; k < tiles; k++)
+    {
+        // the diagonal tile depends only on itself
+        impl_::AllPairsShortestPaths__tile(m, lo(k), hi(k), lo(k), hi(k), lo(k), hi(k));
+
+        // then the rest of row k and column k, which depend on the diagonal
+        parallelFor(0, 2 * tiles, threads, [&](long long x)
+        {
+            int t = x / 2;
+            if(t == k)
+                return;
+            if(x % 2 == 0)
+                impl_::AllPairsShortestPaths__tile(m, lo(k), hi(k), lo(t), hi(t), lo(k), hi(k));
+            else
+                impl_::AllPairsShortestPaths__tile(m, lo(t), hi(t), lo(k), hi(k), lo(k), hi(k));
+        });
+
+        // then everything else, which depends on row k and column k
+        parallelFor(0, static_cast<long long>(tiles) * tiles, threads, [&](long long x)
+        {
+            int i = x / tiles;
+            int j = x % tiles;
+            if(i != k && j != k)
+                impl_::AllPairsShortestPaths__tile(m, lo(i), hi(i), lo(j), hi(j), lo(k), hi(k));
+        });
+    }
+
+    for(int v = 0; v < n; v++)
+        if(m(v, v) < 0.0)
+            throw DigraphException{std::string("When floydWarshall, graph has a negative cycle!")};
+
+    return m;
+}
+
+
+inline DistanceMatrix johnson(const CSRGraph& g, unsigned int threads)
+{
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When johnson, graph has no weights!")};
+
+    int n = g.vertexCount();
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+    const CSRArray<double>& weights = g.weights();
+
+    // Bellman-Ford from a virtual vertex with a zero-weight edge to every
+    // vertex, so every potential starts at zero
+    std::vector<double> h(n, 0.0);
+    bool changed = true;
+    for(int round = 0; round <= n && changed; round++)
+    {
+        changed = false;
+        for(int v = 0; v < n; v++)
+        {
+            for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                if(h[v] + weights[i] < h[targets[i]])
+                {
+                    h[targets[i]] = h[v] + weights[i];
+                    changed = true;
+                }
+            }
+        }
+    }
+    if(changed)
+        throw DigraphException{std::string("When johnson, graph has a negative cycle!")};
+
+    // with the potentials, w(u, v) + h(u) - h(v) is never negative (aside
+    // from rounding, which is clamped away)
+    std::vector<double> reweighted(g.edgeCount());
+    for(int v = 0; v < n; v++)
+        for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            reweighted[i] = std::max(0.0, weights[i] + h[v] - h[targets[i]]);
+
+    std::vector<int> sources(g.vertexNumbers().begin(), g.vertexNumbers().end());
+    DistanceMatrix m = multiSourceShortestPaths(g.withWeights(std::move(reweighted)), sources, threads);
+
+    parallelFor(0, n, threads, [&](long long u)
+    {
+        double* row = m.row(u);
+        for(int v = 0; v < n; v++)
+            if(row[v] != std::numeric_limits<double>::infinity())
+                row[v] += h[v] - h[u];
+    });
+
+    return m;
+}
+
+
+
+#endif // ALLPAIRSSHORTESTPATHS_HPP
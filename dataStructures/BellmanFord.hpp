@@ -0,0 +1,227 @@
+// BellmanFord.hpp
+//
+//
+// Single-source shortest paths over a weighted CSRGraph snapshot when
+// some edge weights may be negative, which Dijkstra's algorithm (and so
+// Digraph::findShortestPaths() and deltaStepping()) can't handle.
+//
+//   * bellmanFord() relaxes every edge in rounds until nothing changes.
+//     Each round is "pull-based" over the transposed snapshot: every
+//     vertex takes the best of its incoming edges, reading the previous
+//     round's distances, so the vertices can be split among threads with
+//     no atomics or locks.
+//
+//   * spfa() (the "shortest path faster algorithm") is the queue-based
+//     variant: only the edges of vertices whose distance just changed are
+//     relaxed, which on most graphs is far less work than full rounds.
+//
+// Both detect a cycle of negative total weight reachable from the start
+// vertex, in which case no shortest paths exist and a DigraphException
+// is thrown.  Results follow the ShortestPathTree conventions of
+// deltaStepping().
+//
+
+#ifndef BELLMANFORD_HPP
+#define BELLMANFORD_HPP
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "DeltaStepping.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// bellmanFord() computes shortest paths from the vertex with the given
+// vertex number in a weighted CSRGraph, using the given number of threads
+// (zero meaning one per hardware thread).  If the snapshot has no
+// weights, does not contain the start vertex, or has a negative cycle
+// reachable from it, a DigraphException is thrown instead.
+ShortestPathTree bellmanFord(const CSRGraph& g, int startVertex, unsigned int threads = 0);
+
+
+// spfa() computes the same result as bellmanFord(), on one thread.
+ShortestPathTree spfa(const CSRGraph& g, int startVertex);
+
+
+// findShortestPathsNegative() is a counterpart to
+// Digraph::findShortestPaths() that allows negative edge weights: it
+// snapshots the Digraph, runs spfa(), and returns the predecessor of
+// every vertex keyed by vertex number.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> findShortestPathsNegative(
+    const Digraph<VertexInfo, EdgeInfo>& d, int startVertex, EdgeWeightFunc edgeWeightFunc);
+
+
+
+inline ShortestPathTree bellmanFord(const CSRGraph& g, int startVertex, unsigned int threads)
+{
+    int n = g.vertexCount();
+    int start = g.indexOf(startVertex);
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When bellmanFord, graph has no weights!")};
+
+    CSRGraph transposed = g.transpose();
+    const CSRArray<int>& inOffsets = transposed.offsets();
+    const CSRArray<int>& inSources = transposed.targets();
+    const CSRArray<double>& inWeights = transposed.weights();
+
+    ShortestPathTree result;
+    result.distance.assign(n, std::numeric_limits<double>::infinity());
+    result.predecessor.resize(n);
+    for(int i = 0; i < n; i++)
+        result.predecessor[i] = i;
+    result.distance[start] = 0.0;
+
+    std::vector<double> next(result.distance);
+    threads = std::min<unsigned int>(resolveThreadCount(threads), std::max(n, 1));
+    long long chunk = (static_cast<long long>(n) + threads - 1) / threads;
+    std::vector<char> changed(threads);
+
+    std::vector<double>& distance = result.distance;
+    Barrier barrier{threads};
+    bool swapped = false;
+    bool negativeCycle = false;
+
+    // with no negative cycle, every shortest path has fewer than n edges,
+    // so distances settle within n - 1 rounds; the workers are started
+    // once, and every thread reads the per-thread flags itself to agree on
+    // when to stop
+    runThreads(threads, [&](unsigned int t)
+    {
+        std::vector<double>* current = &distance;
+        std::vector<double>* following = &next;
+        long long lo = t * chunk;
+        long long hi = std::min<long long>(n, lo + chunk);
+
+        for(int round = 0; ; round++)
+        {
+            const std::vector<double>& d = *current;
+            std::vector<double>& out = *following;
+            bool any = false;
+            for(long long v = lo; v < hi; v++)
+            {
+                double best = d[v];
+                int via = -1;
+                for(int i = inOffsets[v]; i < inOffsets[v + 1]; i++)
+                {
+                    double candidate = d[inSources[i]] + inWeights[i];
+                    if(candidate < best)
+                    {
+                        best = candidate;
+                        via = inSources[i];
+                    }
+                }
+                out[v] = best;
+                if(via != -1)
+                {
+                    result.predecessor[v] = via;
+                    any = true;
+                }
+            }
+            changed[t] = any;
+            barrier.wait();
+
+            std::swap(current, following);
+            bool again = std::find(changed.begin(), changed.end(), true) != changed.end();
+            barrier.wait();
+            if(!again)
+                break;
+            if(round >= n - 1)
+            {
+                if(t == 0)
+                    negativeCycle = true;
+                break;
+            }
+        }
+
+        if(t == 0)
+            swapped = current != &distance;
+    });
+
+    if(negativeCycle)
+        throw DigraphException{std::string("When bellmanFord, graph has a negative cycle!")};
+    if(swapped)
+        distance.swap(next);
+
+    return result;
+}
+
+
+inline ShortestPathTree spfa(const CSRGraph& g, int startVertex)
+{
+    int n = g.vertexCount();
+    int start = g.indexOf(startVertex);
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When spfa, graph has no weights!")};
+
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+    const CSRArray<double>& weights = g.weights();
+
+    ShortestPathTree result;
+    result.distance.assign(n, std::numeric_limits<double>::infinity());
+    result.predecessor.resize(n);
+    for(int i = 0; i < n; i++)
+        result.predecessor[i] = i;
+    std::vector<double>& dist = result.distance;
+    std::vector<int>& pred = result.predecessor;
+
+    // edges[v] counts the edges on the current path to v; a path of n
+    // edges repeats a vertex, which only happens around a negative cycle
+    std::vector<int> edges(n, 0);
+    std::vector<char> queued(n, false);
+    std::deque<int> queue{start};
+    dist[start] = 0.0;
+    queued[start] = true;
+
+    while(!queue.empty())
+    {
+        int v = queue.front();
+        queue.pop_front();
+        queued[v] = false;
+
+        for(int i = offsets[v]; i < offsets[v + 1]; i++)
+        {
+            int w = targets[i];
+            double candidate = dist[v] + weights[i];
+            if(candidate < dist[w])
+            {
+                dist[w] = candidate;
+                pred[w] = v;
+                edges[w] = edges[v] + 1;
+                if(edges[w] >= n)
+                    throw DigraphException{std::string("When spfa, graph has a negative cycle!")};
+                if(!queued[w])
+                {
+                    queued[w] = true;
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> findShortestPathsNegative(
+    const Digraph<VertexInfo, EdgeInfo>& d, int startVertex, EdgeWeightFunc edgeWeightFunc)
+{
+    CSRGraph g{d, edgeWeightFunc};
+    ShortestPathTree tree = spfa(g, startVertex);
+
+    std::map<int, int> ans;
+    for(int i = 0; i < g.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), g.vertexNumber(i), g.vertexNumber(tree.predecessor[i]));
+    return ans;
+}
+
+
+
+#endif // BELLMANFORD_HPP
@@ -0,0 +1,233 @@
+// BreadthFirstSearch.hpp
+//
+//
+// A multi-threaded, direction-optimizing breadth-first search (Beamer,
+// Asanovic and Patterson) over a CSRGraph snapshot.
+//
+// While the frontier is small, each level is expanded "top-down": every
+// frontier vertex scans its outgoing edges and claims unvisited targets.
+// Once the frontier's edges make up a large share of what is left to
+// explore, the search switches to "bottom-up": every unvisited vertex
+// scans its incoming edges and stops at the first parent it finds in the
+// frontier, which skips most of the edges a top-down step would check.
+// Bottom-up steps keep the frontier as a bitmap with one bit per vertex.
+//
+// For a one-off search on a small Digraph, Digraph::breadthFirstSearch()
+// is simpler; this version is meant for repeated searches on a large,
+// unchanging graph, with the snapshot and its transpose built once.
+//
+
+#ifndef BREADTHFIRSTSEARCH_HPP
+#define BREADTHFIRSTSEARCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Parallel.hpp"
+
+
+// A BFSTree holds the result of a breadth-first search on a CSRGraph,
+// indexed by dense vertex index.  Unreached vertices have a level and
+// parent of -1; the start vertex has level 0 and is its own parent.
+struct BFSTree
+{
+    std::vector<int> level;
+    std::vector<int> parent;
+};
+
+
+// breadthFirstSearch() searches g from the vertex with the given vertex
+// number.  transposed must be g.transpose(); it is passed in so that it
+// can be built once and reused across searches.  A thread count of zero
+// uses one per hardware thread.  If the start vertex does not exist, a
+// DigraphException is thrown instead.
+BFSTree breadthFirstSearch(
+    const CSRGraph& g, const CSRGraph& transposed, int startVertex, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    // The switching thresholds from the direction-optimizing BFS paper:
+    // go bottom-up once the frontier's edges exceed 1/ALPHA of the edges
+    // still unexplored, and back top-down once the frontier shrinks below
+    // 1/BETA of the vertices.
+    constexpr long long BreadthFirstSearch__ALPHA = 14;
+    constexpr long long BreadthFirstSearch__BETA = 24;
+}
+
+
+inline BFSTree breadthFirstSearch(
+    const CSRGraph& g, const CSRGraph& transposed, int startVertex, unsigned int threads)
+{
+    int n = g.vertexCount();
+    int start = g.indexOf(startVertex);
+    threads = resolveThreadCount(threads);
+
+    const CSRArray<int>& outOffsets = g.offsets();
+    const CSRArray<int>& outTargets = g.targets();
+    const CSRArray<int>& inOffsets = transposed.offsets();
+    const CSRArray<int>& inSources = transposed.targets();
+
+    BFSTree tree;
+    tree.level.assign(n, -1);
+    std::vector<std::atomic<int>> parent(n);
+    for(int i = 0; i < n; i++)
+        parent[i].store(-1, std::memory_order_relaxed);
+
+    parent[start].store(start, std::memory_order_relaxed);
+    tree.level[start] = 0;
+
+    int words = (n + 63) / 64;
+    std::vector<std::uint64_t> frontierBits(words);
+    std::vector<std::uint64_t> nextBits(words);
+    std::vector<int> frontier{start};
+    bool bottomUp = false;
+
+    long long unexploredEdges = g.edgeCount();
+    int depth = 0;
+
+    std::vector<std::vector<int>> localNext(threads);
+    std::vector<long long> found(threads, 0);
+    long long wordsPerThread = (words + threads - 1) / threads;
+    unsigned int active = 0;
+    long long chunk = 0;
+    bool finished = false;
+    Barrier barrier{threads};
+
+    // the workers are started once; between levels, thread 0 alone looks
+    // at what the last level found and picks the direction of the next,
+    // while the others wait at the barrier
+    runThreads(threads, [&](unsigned int t)
+    {
+        while(true)
+        {
+            if(t == 0)
+            {
+                if(frontier.empty() && !bottomUp)
+                    finished = true;
+
+                if(!finished && !bottomUp)
+                {
+                    long long frontierEdges = 0;
+                    for(int v : frontier)
+                        frontierEdges += g.outDegree(v);
+                    unexploredEdges -= frontierEdges;
+
+                    if(frontierEdges * impl_::BreadthFirstSearch__ALPHA > unexploredEdges)
+                    {
+                        std::fill(frontierBits.begin(), frontierBits.end(), 0);
+                        for(int v : frontier)
+                            frontierBits[v / 64] |= std::uint64_t{1} << (v % 64);
+                        bottomUp = true;
+                    }
+                }
+
+                if(!finished && bottomUp)
+                    std::fill(nextBits.begin(), nextBits.end(), 0);
+                else if(!finished)
+                {
+                    active = std::min<long long>(threads, frontier.size());
+                    chunk = (frontier.size() + active - 1) / active;
+                }
+            }
+            barrier.wait();
+            if(finished)
+                break;
+
+            if(bottomUp)
+            {
+                // bottom-up: threads own whole 64-vertex words of nextBits,
+                // so the bitmap needs no atomics; parent entries are owned too
+                found[t] = 0;
+                long long lo = t * wordsPerThread * 64;
+                long long hi = std::min<long long>(n, lo + wordsPerThread * 64);
+                for(long long v = lo; v < hi; v++)
+                {
+                    if(parent[v].load(std::memory_order_relaxed) != -1)
+                        continue;
+                    for(int i = inOffsets[v]; i < inOffsets[v + 1]; i++)
+                    {
+                        int u = inSources[i];
+                        if(frontierBits[u / 64] & (std::uint64_t{1} << (u % 64)))
+                        {
+                            parent[v].store(u, std::memory_order_relaxed);
+                            tree.level[v] = depth + 1;
+                            nextBits[v / 64] |= std::uint64_t{1} << (v % 64);
+                            found[t]++;
+                            break;
+                        }
+                    }
+                }
+            }
+            else if(t < active)
+            {
+                // top-down: claim each unvisited target with a compare-and-swap
+                // so that exactly one frontier vertex becomes its parent
+                std::vector<int>& next = localNext[t];
+                next.clear();
+                long long lo = t * chunk;
+                long long hi = std::min<long long>(frontier.size(), lo + chunk);
+                for(long long k = lo; k < hi; k++)
+                {
+                    int v = frontier[k];
+                    for(int i = outOffsets[v]; i < outOffsets[v + 1]; i++)
+                    {
+                        int w = outTargets[i];
+                        int expected = -1;
+                        if(parent[w].load(std::memory_order_relaxed) == -1
+                           && parent[w].compare_exchange_strong(expected, v, std::memory_order_relaxed))
+                        {
+                            tree.level[w] = depth + 1;
+                            next.push_back(w);
+                        }
+                    }
+                }
+            }
+            barrier.wait();
+
+            if(t != 0)
+                continue;
+
+            if(bottomUp)
+            {
+                long long awake = 0;
+                for(long long f : found)
+                    awake += f;
+                frontierBits.swap(nextBits);
+                depth++;
+
+                if(awake == 0)
+                    finished = true;
+                else if(awake * impl_::BreadthFirstSearch__BETA < n)
+                {
+                    frontier.clear();
+                    for(int w = 0; w < words; w++)
+                        if(frontierBits[w] != 0)
+                            for(int b = 0; b < 64; b++)
+                                if(frontierBits[w] & (std::uint64_t{1} << b))
+                                    frontier.push_back(w * 64 + b);
+                    bottomUp = false;
+                }
+            }
+            else
+            {
+                frontier.clear();
+                for(unsigned int k = 0; k < active; k++)
+                    frontier.insert(frontier.end(), localNext[k].begin(), localNext[k].end());
+                depth++;
+            }
+        }
+    });
+
+    tree.parent.resize(n);
+    for(int i = 0; i < n; i++)
+        tree.parent[i] = parent[i].load(std::memory_order_relaxed);
+    return tree;
+}
+
+
+
+#endif // BREADTHFIRSTSEARCH_HPP
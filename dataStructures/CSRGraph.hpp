@@ -0,0 +1,525 @@
+// CSRGraph.hpp
+//
+//
+// A CSRGraph is a read-only snapshot of a Digraph's topology stored in
+// "compressed sparse row" form: every vertex is given a dense index from
+// 0 to n - 1 (in increasing order of vertex number), and the targets of
+// all edges are packed into one array so that the outgoing edges of the
+// vertex with index i are targets()[offsets()[i]] through
+// targets()[offsets()[i + 1] - 1].  Optionally, an edge weight is stored
+// alongside each target.
+//
+// A snapshot can also be reordered (see reorder() and Reordering.hpp), in
+// which case the dense indices follow some other order chosen to keep
+// neighboring vertices close together in memory.  Everything that works
+// on dense indices works the same way on a reordered snapshot.
+//
+// Because everything lives in a few contiguous arrays, a CSRGraph is the
+// form the parallel and cache-sensitive algorithms work on, and it can be
+// shared read-only between threads.
+//
+// Each array is a CSRArray, which either owns its elements or merely
+// views elements that live somewhere else (such as a memory-mapped graph
+// file), so that a CSRGraph can be used without copying them in.
+//
+
+#ifndef CSRGRAPH_HPP
+#define CSRGRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+// A CSRArray is a read-only array of T that either owns its elements in a
+// std::vector or views elements owned by someone else, who must then keep
+// them alive for as long as the CSRArray (and any copy of it) is used.
+// Copying an owning CSRArray copies the elements; copying a viewing one
+// only copies the view.
+
+template <typename T>
+class CSRArray
+{
+public:
+    CSRArray() = default;
+
+    // Takes ownership of the elements of the given std::vector.
+    CSRArray(std::vector<T> elements);
+
+    // Views count elements starting at the given address.
+    CSRArray(const T* first, std::size_t count);
+
+    CSRArray(const CSRArray& a);
+    CSRArray(CSRArray&& a) noexcept;
+    CSRArray& operator=(const CSRArray& a);
+    CSRArray& operator=(CSRArray&& a) noexcept;
+
+    const T& operator[](std::size_t i) const;
+    const T* begin() const noexcept;
+    const T* end() const noexcept;
+    const T* data() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+private:
+    std::vector<T> owned;
+    const T* first = nullptr;
+    std::size_t count = 0;
+};
+
+
+template <typename T>
+CSRArray<T>::CSRArray(std::vector<T> elements)
+    : owned{std::move(elements)}, first{owned.data()}, count{owned.size()}
+{
+}
+
+
+template <typename T>
+CSRArray<T>::CSRArray(const T* first, std::size_t count)
+    : first{first}, count{count}
+{
+}
+
+
+template <typename T>
+CSRArray<T>::CSRArray(const CSRArray& a)
+    : owned{a.owned}, first{a.first == a.owned.data() ? owned.data() : a.first}, count{a.count}
+{
+}
+
+
+// moving a std::vector hands over its buffer, so the view stays valid
+template <typename T>
+CSRArray<T>::CSRArray(CSRArray&& a) noexcept
+    : owned{std::move(a.owned)}, first{a.first}, count{a.count}
+{
+    a.first = nullptr;
+    a.count = 0;
+}
+
+
+template <typename T>
+CSRArray<T>& CSRArray<T>::operator=(const CSRArray& a)
+{
+    if(this != &a)
+    {
+        CSRArray copy{a};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename T>
+CSRArray<T>& CSRArray<T>::operator=(CSRArray&& a) noexcept
+{
+    if(this != &a)
+    {
+        owned = std::move(a.owned);
+        first = a.first;
+        count = a.count;
+        a.first = nullptr;
+        a.count = 0;
+    }
+    return *this;
+}
+
+
+template <typename T>
+const T& CSRArray<T>::operator[](std::size_t i) const
+{
+    return first[i];
+}
+
+
+template <typename T>
+const T* CSRArray<T>::begin() const noexcept
+{
+    return first;
+}
+
+
+template <typename T>
+const T* CSRArray<T>::end() const noexcept
+{
+    return first + count;
+}
+
+
+template <typename T>
+const T* CSRArray<T>::data() const noexcept
+{
+    return first;
+}
+
+
+template <typename T>
+std::size_t CSRArray<T>::size() const noexcept
+{
+    return count;
+}
+
+
+template <typename T>
+bool CSRArray<T>::empty() const noexcept
+{
+    return count == 0;
+}
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class MappedGraph;
+
+
+
+class CSRGraph
+{
+public:
+    // Initializes an empty CSRGraph with no vertices and no edges.
+    CSRGraph();
+
+    // Takes a snapshot of the topology of the given Digraph, without
+    // edge weights.
+    template <typename VertexInfo, typename EdgeInfo>
+    explicit CSRGraph(const Digraph<VertexInfo, EdgeInfo>& d);
+
+    // Takes a snapshot of the given Digraph, storing for each edge the
+    // weight determined by edgeWeightFunc, exactly as the Digraph's own
+    // findShortestPaths() would see it.
+    template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+    CSRGraph(const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc);
+
+    // Takes ownership of ready-made arrays in the layout described above:
+    // vertexNumbers in increasing order, offsets with one more entry than
+    // there are vertices, targets as dense indices, and weights either
+    // empty or with one entry per target.  If the arrays are inconsistent
+    // with one another, a DigraphException is thrown instead.
+    CSRGraph(std::vector<int> vertexNumbers, std::vector<int> offsets,
+             std::vector<int> targets, std::vector<double> weights);
+
+    // vertexCount() returns the number of vertices in the snapshot.
+    int vertexCount() const noexcept;
+
+    // edgeCount() returns the number of edges in the snapshot.
+    int edgeCount() const noexcept;
+
+    // hasWeights() returns true if the snapshot stores edge weights.
+    bool hasWeights() const noexcept;
+
+    // vertexNumber() returns the Digraph vertex number of the vertex with
+    // the given dense index.
+    int vertexNumber(int index) const;
+
+    // indexOf() returns the dense index of the vertex with the given
+    // Digraph vertex number.  If there is no such vertex, a
+    // DigraphException is thrown instead.
+    int indexOf(int vertex) const;
+
+    // isReordered() returns true if the dense indices are not in
+    // increasing order of vertex number.
+    bool isReordered() const noexcept;
+
+    // outDegree() returns the number of edges outgoing from the vertex
+    // with the given dense index.
+    int outDegree(int index) const;
+
+    // withWeights() returns a snapshot with the same vertices and edges
+    // as this one but with the given per-edge weights (one per target, in
+    // the same order).  The topology arrays are copied the same way the
+    // CSRGraph itself would be, so views stay views.  If the number of
+    // weights is wrong, a DigraphException is thrown instead.
+    CSRGraph withWeights(std::vector<double> weights) const;
+
+    // transpose() returns a snapshot of the same vertices with every edge
+    // reversed (weights travel with their edges), so that the outgoing
+    // edges of a vertex in the result are its incoming edges here.
+    CSRGraph transpose() const;
+
+    // reorder() returns a snapshot with the same vertices and edges (and
+    // weights) in which the vertex with dense index i here has dense index
+    // newIndex[i]; each vertex keeps its outgoing edges in the same order.
+    // If newIndex is not a permutation of the dense indices, a
+    // DigraphException is thrown instead.
+    CSRGraph reorder(const std::vector<int>& newIndex) const;
+
+    // The underlying arrays.  offsets() has vertexCount() + 1 entries;
+    // targets() (and weights(), if present) have edgeCount() entries.
+    const CSRArray<int>& vertexNumbers() const noexcept;
+    const CSRArray<int>& offsets() const noexcept;
+    const CSRArray<int>& targets() const noexcept;
+    const CSRArray<double>& weights() const noexcept;
+
+private:
+    // a MappedGraph points the arrays straight at its file
+    template <typename VertexInfo, typename EdgeInfo>
+    friend class MappedGraph;
+
+    template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+    void build(const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc* edgeWeightFunc);
+
+private:
+    CSRArray<int> numbers;
+    CSRArray<int> firstEdge;
+    CSRArray<int> edgeTargets;
+    CSRArray<double> edgeWeights;
+
+    // empty unless reordered, in which case it holds the dense indices
+    // in increasing order of vertex number, for indexOf()
+    CSRArray<int> byNumber;
+};
+
+
+inline CSRGraph::CSRGraph()
+    : firstEdge{std::vector<int>(1, 0)}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CSRGraph::CSRGraph(const Digraph<VertexInfo, EdgeInfo>& d)
+{
+    build(d, static_cast<double(*)(const EdgeInfo&)>(nullptr));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+CSRGraph::CSRGraph(const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc)
+{
+    build(d, &edgeWeightFunc);
+}
+
+
+inline CSRGraph::CSRGraph(std::vector<int> vertexNumbers, std::vector<int> offsets,
+                          std::vector<int> targets, std::vector<double> weights)
+    : numbers{std::move(vertexNumbers)}, firstEdge{std::move(offsets)},
+      edgeTargets{std::move(targets)}, edgeWeights{std::move(weights)}
+{
+    int n = numbers.size();
+    if(static_cast<int>(firstEdge.size()) != n + 1 || firstEdge[0] != 0
+       || firstEdge[n] != static_cast<int>(edgeTargets.size()))
+        throw DigraphException{std::string("When CSRGraph, offsets don't match the targets!")};
+    if(!edgeWeights.empty() && edgeWeights.size() != edgeTargets.size())
+        throw DigraphException{std::string("When CSRGraph, weights don't match the targets!")};
+    for(int i = 0; i < n; i++)
+        if(firstEdge[i] > firstEdge[i + 1] || (i > 0 && numbers[i - 1] >= numbers[i]))
+            throw DigraphException{std::string("When CSRGraph, arrays are out of order!")};
+    for(int t : edgeTargets)
+        if(t < 0 || t >= n)
+            throw DigraphException{std::string("When CSRGraph, target out of range!")};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+void CSRGraph::build(const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc* edgeWeightFunc)
+{
+    numbers = std::vector<int>(d.vertexView().begin(), d.vertexView().end());
+    int n = numbers.size();
+
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> targets;
+    std::vector<double> weights;
+    targets.reserve(d.edgeCount());
+    if(edgeWeightFunc != nullptr)
+        weights.reserve(d.edgeCount());
+
+    for(int i = 0; i < n; i++)
+    {
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(numbers[i]))
+        {
+            targets.push_back(indexOf(e.toVertex));
+            if(edgeWeightFunc != nullptr)
+                weights.push_back((*edgeWeightFunc)(e.einfo));
+        }
+        offsets[i + 1] = targets.size();
+    }
+
+    firstEdge = std::move(offsets);
+    edgeTargets = std::move(targets);
+    edgeWeights = std::move(weights);
+}
+
+
+inline int CSRGraph::vertexCount() const noexcept
+{
+    return numbers.size();
+}
+
+
+inline int CSRGraph::edgeCount() const noexcept
+{
+    return edgeTargets.size();
+}
+
+
+inline bool CSRGraph::hasWeights() const noexcept
+{
+    return !edgeWeights.empty() || edgeTargets.empty();
+}
+
+
+inline int CSRGraph::vertexNumber(int index) const
+{
+    return numbers[index];
+}
+
+
+inline int CSRGraph::indexOf(int vertex) const
+{
+    if(byNumber.empty())
+    {
+        auto it = std::lower_bound(numbers.begin(), numbers.end(), vertex);
+        if(it == numbers.end() || *it != vertex)
+            throw DigraphException{std::string("When CSRGraph indexOf, vertex not found!")};
+        return it - numbers.begin();
+    }
+
+    auto it = std::lower_bound(byNumber.begin(), byNumber.end(), vertex,
+                               [&](int index, int v) { return numbers[index] < v; });
+    if(it == byNumber.end() || numbers[*it] != vertex)
+        throw DigraphException{std::string("When CSRGraph indexOf, vertex not found!")};
+    return *it;
+}
+
+
+inline bool CSRGraph::isReordered() const noexcept
+{
+    return !byNumber.empty();
+}
+
+
+inline int CSRGraph::outDegree(int index) const
+{
+    return firstEdge[index + 1] - firstEdge[index];
+}
+
+
+inline CSRGraph CSRGraph::withWeights(std::vector<double> weights) const
+{
+    if(weights.size() != edgeTargets.size())
+        throw DigraphException{std::string("When CSRGraph withWeights, wrong number of weights!")};
+
+    CSRGraph g;
+    g.numbers = numbers;
+    g.firstEdge = firstEdge;
+    g.edgeTargets = edgeTargets;
+    g.edgeWeights = std::move(weights);
+    g.byNumber = byNumber;
+    return g;
+}
+
+
+inline CSRGraph CSRGraph::transpose() const
+{
+    int n = numbers.size();
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> sources(edgeTargets.size());
+    std::vector<double> weights(edgeWeights.size());
+
+    for(int target : edgeTargets)
+        offsets[target + 1]++;
+    for(int i = 0; i < n; i++)
+        offsets[i + 1] += offsets[i];
+
+    std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+    for(int v = 0; v < n; v++)
+    {
+        for(int i = firstEdge[v]; i < firstEdge[v + 1]; i++)
+        {
+            int p = pos[edgeTargets[i]]++;
+            sources[p] = v;
+            if(!edgeWeights.empty())
+                weights[p] = edgeWeights[i];
+        }
+    }
+
+    CSRGraph t;
+    t.numbers = numbers;
+    t.firstEdge = std::move(offsets);
+    t.edgeTargets = std::move(sources);
+    t.edgeWeights = std::move(weights);
+    t.byNumber = byNumber;
+    return t;
+}
+
+
+inline CSRGraph CSRGraph::reorder(const std::vector<int>& newIndex) const
+{
+    int n = numbers.size();
+    if(static_cast<int>(newIndex.size()) != n)
+        throw DigraphException{std::string("When CSRGraph reorder, newIndex has the wrong size!")};
+    std::vector<int> oldIndex(n, -1);
+    for(int i = 0; i < n; i++)
+    {
+        if(newIndex[i] < 0 || newIndex[i] >= n || oldIndex[newIndex[i]] != -1)
+            throw DigraphException{std::string("When CSRGraph reorder, newIndex is not a permutation!")};
+        oldIndex[newIndex[i]] = i;
+    }
+
+    std::vector<int> reorderedNumbers(n);
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> targets(edgeTargets.size());
+    std::vector<double> weights(edgeWeights.size());
+    for(int v = 0; v < n; v++)
+    {
+        int old = oldIndex[v];
+        reorderedNumbers[v] = numbers[old];
+        offsets[v + 1] = offsets[v] + (firstEdge[old + 1] - firstEdge[old]);
+        for(int i = firstEdge[old], j = offsets[v]; i < firstEdge[old + 1]; i++, j++)
+        {
+            targets[j] = newIndex[edgeTargets[i]];
+            if(!edgeWeights.empty())
+                weights[j] = edgeWeights[i];
+        }
+    }
+
+    // the vertices in increasing order of vertex number are those of this
+    // snapshot, in their new places
+    std::vector<int> sorted(n);
+    for(int k = 0; k < n; k++)
+        sorted[k] = newIndex[byNumber.empty() ? k : byNumber[k]];
+    bool identity = true;
+    for(int v = 0; v < n && identity; v++)
+        identity = sorted[v] == v;
+
+    CSRGraph g;
+    g.numbers = std::move(reorderedNumbers);
+    g.firstEdge = std::move(offsets);
+    g.edgeTargets = std::move(targets);
+    g.edgeWeights = std::move(weights);
+    if(!identity)
+        g.byNumber = std::move(sorted);
+    return g;
+}
+
+
+inline const CSRArray<int>& CSRGraph::vertexNumbers() const noexcept
+{
+    return numbers;
+}
+
+
+inline const CSRArray<int>& CSRGraph::offsets() const noexcept
+{
+    return firstEdge;
+}
+
+
+inline const CSRArray<int>& CSRGraph::targets() const noexcept
+{
+    return edgeTargets;
+}
+
+
+inline const CSRArray<double>& CSRGraph::weights() const noexcept
+{
+    return edgeWeights;
+}
+
+
+
+#endif // CSRGRAPH_HPP
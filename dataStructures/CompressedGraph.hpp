@@ -0,0 +1,488 @@
+// CompressedGraph.hpp
+//
+//
+// A CompressedGraph is a read-only snapshot of a graph's topology, like a
+// CSRGraph, with each vertex's list of targets compressed to take a
+// fraction of the memory.
+//
+// Each list is sorted and stored as the differences ("gaps") between
+// consecutive targets, which in a graph with any locality (or after
+// reverseCuthillMcKee(), see Reordering.hpp) are mostly small numbers.
+// Every number is then written as a variable-length integer ("varint"):
+// seven bits per byte, with the high bit set on every byte but the last,
+// so a gap below 128 takes one byte instead of four.  A list starts with
+// the vertex's out-degree, followed by its first target relative to the
+// vertex itself (which can be negative, so it is "zigzag" encoded to
+// keep small magnitudes small) and then the gaps.  Only the position
+// where each list starts is stored uncompressed.
+//
+// Targets are decoded on the fly as they are iterated, either through
+// neighbors(), which can be used with a range-based for loop, or through
+// forEachNeighbor(), which is slightly faster.  Dense indices and vertex
+// numbers work as they do for the CSRGraph the CompressedGraph was made
+// from, and breadthFirstSearch() has an overload that works on a
+// CompressedGraph directly.
+//
+
+#ifndef COMPRESSEDGRAPH_HPP
+#define COMPRESSEDGRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "BreadthFirstSearch.hpp"
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+
+
+namespace impl_
+{
+    inline void CompressedGraph__writeVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+
+
+    inline std::uint64_t CompressedGraph__readVarint(const std::uint8_t*& p)
+    {
+        std::uint64_t value = *p & 0x7f;
+        int shift = 7;
+        while(*p++ & 0x80)
+        {
+            value |= static_cast<std::uint64_t>(*p & 0x7f) << shift;
+            shift += 7;
+        }
+        return value;
+    }
+
+
+    inline std::uint64_t CompressedGraph__zigzag(long long value)
+    {
+        return value < 0 ? (static_cast<std::uint64_t>(-(value + 1)) << 1) | 1
+                         : static_cast<std::uint64_t>(value) << 1;
+    }
+
+
+    inline long long CompressedGraph__unzigzag(std::uint64_t value)
+    {
+        return (value & 1) ? -static_cast<long long>(value >> 1) - 1 : static_cast<long long>(value >> 1);
+    }
+}
+
+
+
+class CompressedGraph
+{
+public:
+    // A NeighborIterator decodes the targets of one vertex (as dense
+    // indices, in increasing order) one at a time.
+    class NeighborIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef int reference;
+
+        NeighborIterator() = default;
+        NeighborIterator(const std::uint8_t* position, int vertex, int remaining);
+
+        int operator*() const noexcept;
+        NeighborIterator& operator++();
+        NeighborIterator operator++(int);
+        bool operator==(const NeighborIterator& other) const noexcept;
+        bool operator!=(const NeighborIterator& other) const noexcept;
+
+    private:
+        const std::uint8_t* position = nullptr;
+        int current = 0;
+        int remaining = 0;
+    };
+
+
+    // A NeighborRange is what neighbors() returns, for use with a
+    // range-based for loop.
+    class NeighborRange
+    {
+    public:
+        NeighborRange(NeighborIterator first, NeighborIterator last);
+
+        NeighborIterator begin() const noexcept;
+        NeighborIterator end() const noexcept;
+
+    private:
+        NeighborIterator first;
+        NeighborIterator last;
+    };
+
+
+public:
+    // Initializes an empty CompressedGraph with no vertices and no edges.
+    CompressedGraph();
+
+    // Compresses the topology of the given CSRGraph (weights are not
+    // kept), with the same dense indices.
+    explicit CompressedGraph(const CSRGraph& g);
+
+    // Compresses the topology of the given Digraph directly, with the
+    // same dense indices a CSRGraph snapshot would use.
+    template <typename VertexInfo, typename EdgeInfo>
+    explicit CompressedGraph(const Digraph<VertexInfo, EdgeInfo>& d);
+
+    // vertexCount() and edgeCount() return the number of vertices and
+    // edges.
+    int vertexCount() const noexcept;
+    int edgeCount() const noexcept;
+
+    // vertexNumber() returns the vertex number of the vertex with the
+    // given dense index.
+    int vertexNumber(int index) const;
+
+    // indexOf() returns the dense index of the vertex with the given
+    // vertex number.  If there is no such vertex, a DigraphException is
+    // thrown instead.
+    int indexOf(int vertex) const;
+
+    // outDegree() returns the number of edges outgoing from the vertex
+    // with the given dense index.
+    int outDegree(int index) const;
+
+    // neighbors() returns the targets of the edges outgoing from the
+    // vertex with the given dense index, in increasing order.
+    NeighborRange neighbors(int index) const;
+
+    // forEachNeighbor() calls func(target) for every target that
+    // neighbors() would yield.
+    template <typename Func>
+    void forEachNeighbor(int index, Func func) const;
+
+    // byteSize() returns the number of bytes the CompressedGraph uses for
+    // its arrays, for comparison with other representations.
+    std::size_t byteSize() const noexcept;
+
+    // decompress() returns an unweighted CSRGraph with the same vertices
+    // and edges (each vertex's targets in increasing order).
+    CSRGraph decompress() const;
+
+private:
+    void append(int index, std::vector<int>& targets);
+    void finish();
+
+private:
+    std::vector<int> numbers;
+    std::vector<int> byNumber;
+    std::vector<std::uint64_t> firstByte;
+    std::vector<std::uint8_t> bytes;
+    int edges = 0;
+};
+
+
+// This overload of breadthFirstSearch() searches a CompressedGraph from
+// the vertex with the given vertex number, on one thread, top-down only
+// (bottom-up steps would need the compressed transpose as well).  The
+// levels are the same as for the CSRGraph the CompressedGraph was made
+// from, though where a vertex has several possible parents, a different
+// one may be chosen.
+BFSTree breadthFirstSearch(const CompressedGraph& g, int startVertex);
+
+
+
+inline CompressedGraph::NeighborIterator::NeighborIterator(
+    const std::uint8_t* position, int vertex, int remaining)
+    : position{position}, current{vertex}, remaining{remaining}
+{
+    if(remaining > 0)
+        current = vertex + impl_::CompressedGraph__unzigzag(impl_::CompressedGraph__readVarint(this->position));
+}
+
+
+inline int CompressedGraph::NeighborIterator::operator*() const noexcept
+{
+    return current;
+}
+
+
+inline CompressedGraph::NeighborIterator& CompressedGraph::NeighborIterator::operator++()
+{
+    if(--remaining > 0)
+        current += impl_::CompressedGraph__readVarint(position);
+    return *this;
+}
+
+
+inline CompressedGraph::NeighborIterator CompressedGraph::NeighborIterator::operator++(int)
+{
+    NeighborIterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+// iterators over the same list are told apart by how many targets they
+// have left, which is all an end iterator needs to carry
+inline bool CompressedGraph::NeighborIterator::operator==(const NeighborIterator& other) const noexcept
+{
+    return remaining == other.remaining;
+}
+
+
+inline bool CompressedGraph::NeighborIterator::operator!=(const NeighborIterator& other) const noexcept
+{
+    return remaining != other.remaining;
+}
+
+
+inline CompressedGraph::NeighborRange::NeighborRange(NeighborIterator first, NeighborIterator last)
+    : first{first}, last{last}
+{
+}
+
+
+inline CompressedGraph::NeighborIterator CompressedGraph::NeighborRange::begin() const noexcept
+{
+    return first;
+}
+
+
+inline CompressedGraph::NeighborIterator CompressedGraph::NeighborRange::end() const noexcept
+{
+    return last;
+}
+
+
+inline CompressedGraph::CompressedGraph()
+    : firstByte(1, 0)
+{
+}
+
+
+inline CompressedGraph::CompressedGraph(const CSRGraph& g)
+    : numbers(g.vertexNumbers().begin(), g.vertexNumbers().end())
+{
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+
+    firstByte.reserve(numbers.size() + 1);
+    bytes.reserve(targets.size() + 2 * numbers.size());
+    std::vector<int> scratch;
+    for(int v = 0; v < static_cast<int>(numbers.size()); v++)
+    {
+        scratch.assign(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+        append(v, scratch);
+    }
+    finish();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompressedGraph::CompressedGraph(const Digraph<VertexInfo, EdgeInfo>& d)
+    : numbers(d.vertexView().begin(), d.vertexView().end())
+{
+    firstByte.reserve(numbers.size() + 1);
+    bytes.reserve(d.edgeCount() + 2 * numbers.size());
+    std::vector<int> scratch;
+    for(int v = 0; v < static_cast<int>(numbers.size()); v++)
+    {
+        scratch.clear();
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(numbers[v]))
+            scratch.push_back(std::lower_bound(numbers.begin(), numbers.end(), e.toVertex) - numbers.begin());
+        append(v, scratch);
+    }
+    finish();
+}
+
+
+inline void CompressedGraph::append(int index, std::vector<int>& targets)
+{
+    std::sort(targets.begin(), targets.end());
+    firstByte.push_back(bytes.size());
+    impl_::CompressedGraph__writeVarint(bytes, targets.size());
+    int previous = index;
+    for(std::size_t i = 0; i < targets.size(); i++)
+    {
+        if(i == 0)
+            impl_::CompressedGraph__writeVarint(bytes, impl_::CompressedGraph__zigzag(static_cast<long long>(targets[i]) - index));
+        else
+            impl_::CompressedGraph__writeVarint(bytes, targets[i] - previous);
+        previous = targets[i];
+    }
+    edges += targets.size();
+}
+
+
+inline void CompressedGraph::finish()
+{
+    firstByte.push_back(bytes.size());
+    bytes.shrink_to_fit();
+
+    // a snapshot taken from a reordered CSRGraph needs its own lookup
+    // for indexOf(), just as the CSRGraph did
+    if(!std::is_sorted(numbers.begin(), numbers.end()))
+    {
+        byNumber.resize(numbers.size());
+        for(std::size_t i = 0; i < numbers.size(); i++)
+            byNumber[i] = i;
+        std::sort(byNumber.begin(), byNumber.end(), [&](int a, int b) { return numbers[a] < numbers[b]; });
+    }
+}
+
+
+inline int CompressedGraph::vertexCount() const noexcept
+{
+    return numbers.size();
+}
+
+
+inline int CompressedGraph::edgeCount() const noexcept
+{
+    return edges;
+}
+
+
+inline int CompressedGraph::vertexNumber(int index) const
+{
+    return numbers[index];
+}
+
+
+inline int CompressedGraph::indexOf(int vertex) const
+{
+    if(byNumber.empty())
+    {
+        auto it = std::lower_bound(numbers.begin(), numbers.end(), vertex);
+        if(it == numbers.end() || *it != vertex)
+            throw DigraphException{std::string("When CompressedGraph indexOf, vertex not found!")};
+        return it - numbers.begin();
+    }
+
+    auto it = std::lower_bound(byNumber.begin(), byNumber.end(), vertex,
+                               [&](int index, int v) { return numbers[index] < v; });
+    if(it == byNumber.end() || numbers[*it] != vertex)
+        throw DigraphException{std::string("When CompressedGraph indexOf, vertex not found!")};
+    return *it;
+}
+
+
+inline int CompressedGraph::outDegree(int index) const
+{
+    const std::uint8_t* p = bytes.data() + firstByte[index];
+    return impl_::CompressedGraph__readVarint(p);
+}
+
+
+inline CompressedGraph::NeighborRange CompressedGraph::neighbors(int index) const
+{
+    const std::uint8_t* p = bytes.data() + firstByte[index];
+    int degree = impl_::CompressedGraph__readVarint(p);
+    return NeighborRange{NeighborIterator{p, index, degree}, NeighborIterator{nullptr, index, 0}};
+}
+
+
+template <typename Func>
+void CompressedGraph::forEachNeighbor(int index, Func func) const
+{
+    const std::uint8_t* p = bytes.data() + firstByte[index];
+    int degree = impl_::CompressedGraph__readVarint(p);
+    if(degree == 0)
+        return;
+
+    int target = index + impl_::CompressedGraph__unzigzag(impl_::CompressedGraph__readVarint(p));
+    func(target);
+    for(int i = 1; i < degree; i++)
+    {
+        // most gaps fit in one byte, so check for that before looping
+        std::uint64_t gap = *p;
+        if(gap < 0x80)
+            p++;
+        else
+            gap = impl_::CompressedGraph__readVarint(p);
+        target += gap;
+        func(target);
+    }
+}
+
+
+inline std::size_t CompressedGraph::byteSize() const noexcept
+{
+    return numbers.size() * sizeof(int) + byNumber.size() * sizeof(int)
+         + firstByte.size() * sizeof(std::uint64_t) + bytes.size();
+}
+
+
+inline CSRGraph CompressedGraph::decompress() const
+{
+    int n = numbers.size();
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> targets;
+    targets.reserve(edges);
+    for(int v = 0; v < n; v++)
+    {
+        forEachNeighbor(v, [&](int w) { targets.push_back(w); });
+        offsets[v + 1] = targets.size();
+    }
+
+    if(byNumber.empty())
+        return CSRGraph{numbers, std::move(offsets), std::move(targets), std::vector<double>{}};
+
+    // the CSRGraph constructor wants vertex numbers in increasing order,
+    // so build it in that order and then put the vertices back in place
+    std::vector<int> newIndex(n);
+    for(int k = 0; k < n; k++)
+        newIndex[byNumber[k]] = k;
+    std::vector<int> sortedNumbers(n);
+    std::vector<int> sortedOffsets(n + 1, 0);
+    std::vector<int> sortedTargets;
+    sortedTargets.reserve(edges);
+    for(int k = 0; k < n; k++)
+    {
+        int v = byNumber[k];
+        sortedNumbers[k] = numbers[v];
+        for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            sortedTargets.push_back(newIndex[targets[i]]);
+        sortedOffsets[k + 1] = sortedTargets.size();
+    }
+    CSRGraph sorted{std::move(sortedNumbers), std::move(sortedOffsets), std::move(sortedTargets), std::vector<double>{}};
+    return sorted.reorder(byNumber);
+}
+
+
+inline BFSTree breadthFirstSearch(const CompressedGraph& g, int startVertex)
+{
+    int n = g.vertexCount();
+    int start = g.indexOf(startVertex);
+
+    BFSTree tree;
+    tree.level.assign(n, -1);
+    tree.parent.assign(n, -1);
+    tree.level[start] = 0;
+    tree.parent[start] = start;
+
+    std::vector<int> queue{start};
+    for(std::size_t head = 0; head < queue.size(); head++)
+    {
+        int v = queue[head];
+        g.forEachNeighbor(v, [&](int w)
+        {
+            if(tree.level[w] == -1)
+            {
+                tree.level[w] = tree.level[v] + 1;
+                tree.parent[w] = v;
+                queue.push_back(w);
+            }
+        });
+    }
+    return tree;
+}
+
+
+
+#endif // COMPRESSEDGRAPH_HPP
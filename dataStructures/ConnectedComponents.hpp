@@ -0,0 +1,192 @@
+// ConnectedComponents.hpp
+//
+//
+// Weakly connected components (the connected components of a graph when
+// edge directions are ignored) of a CSRGraph snapshot, found in parallel
+// with a lock-free concurrent union-find.
+//
+// Every vertex starts out as its own tree in a forest of parent pointers;
+// linking two vertices hangs the higher of their two roots beneath the
+// lower one with a compare-and-swap, retrying if another thread got
+// there first.  Since roots only ever move to lower indices, each
+// component ends up labeled by its smallest dense index, no matter how
+// the threads interleave.
+//
+// The order of the links follows Afforest (Sutton, Ben-Nun and Barak):
+//
+//   * First, each vertex is linked to just its first two neighbors, which
+//     in most real graphs already joins the bulk of the giant component.
+//
+//   * A small random sample of vertices then guesses which component is
+//     the giant one.
+//
+//   * Finally, the remaining edges are linked, skipping every vertex that
+//     is already in the giant component; since edge directions don't
+//     matter, an edge from such a vertex is instead reached from its other
+//     end, through the transposed snapshot.
+//
+// On graphs with one dominant component, this touches only a fraction of
+// the edges.
+//
+
+#ifndef CONNECTEDCOMPONENTS_HPP
+#define CONNECTEDCOMPONENTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// weaklyConnectedComponents() returns, for every vertex of g by dense
+// index, the smallest dense index in its weakly connected component,
+// using the given number of threads (zero meaning one per hardware
+// thread).
+std::vector<int> weaklyConnectedComponents(const CSRGraph& g, unsigned int threads = 0);
+
+
+// This overload snapshots a Digraph and returns, for every vertex number,
+// the smallest vertex number in its weakly connected component.
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> weaklyConnectedComponents(
+    const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    // Components__link() puts u and v in the same tree, hanging the
+    // higher root beneath the lower one.
+    inline void Components__link(std::vector<std::atomic<int>>& parent, int u, int v)
+    {
+        int p1 = parent[u].load(std::memory_order_relaxed);
+        int p2 = parent[v].load(std::memory_order_relaxed);
+        while(p1 != p2)
+        {
+            int high = std::max(p1, p2);
+            int low = std::min(p1, p2);
+            int expected = high;
+            int highParent = parent[high].load(std::memory_order_relaxed);
+
+            // either high already hangs beneath low, or high is still a
+            // root and the compare-and-swap makes it hang there
+            if(highParent == low
+               || (highParent == high
+                   && parent[high].compare_exchange_strong(expected, low, std::memory_order_acq_rel)))
+                break;
+
+            // someone else moved high first; climb and try again
+            p1 = parent[parent[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+            p2 = parent[low].load(std::memory_order_relaxed);
+        }
+    }
+
+
+    // Components__compress() points every vertex straight at its root.
+    // It must not run at the same time as any link.
+    inline void Components__compress(std::vector<std::atomic<int>>& parent, unsigned int threads)
+    {
+        parallelFor(0, parent.size(), threads, [&](long long v)
+        {
+            int p = parent[v].load(std::memory_order_relaxed);
+            while(p != parent[p].load(std::memory_order_relaxed))
+                p = parent[p].load(std::memory_order_relaxed);
+            parent[v].store(p, std::memory_order_relaxed);
+        });
+    }
+
+
+    // Components__largest() guesses the root of the largest component
+    // from the roots of a random sample of vertices.
+    inline int Components__largest(const std::vector<std::atomic<int>>& parent)
+    {
+        const int samples = 1024;
+        std::mt19937 rng{27491095};
+        std::uniform_int_distribution<int> pick(0, parent.size() - 1);
+        std::unordered_map<int, int> counts;
+        for(int i = 0; i < samples; i++)
+            counts[parent[pick(rng)].load(std::memory_order_relaxed)]++;
+
+        auto largest = std::max_element(counts.begin(), counts.end(),
+            [](const std::pair<const int, int>& a, const std::pair<const int, int>& b)
+            {
+                return a.second < b.second;
+            });
+        return largest->first;
+    }
+}
+
+
+inline std::vector<int> weaklyConnectedComponents(const CSRGraph& g, unsigned int threads)
+{
+    int n = g.vertexCount();
+    if(n == 0)
+        return std::vector<int>{};
+
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+    threads = resolveThreadCount(threads);
+
+    std::vector<std::atomic<int>> parent(n);
+    parallelFor(0, n, threads, [&](long long v)
+    {
+        parent[v].store(v, std::memory_order_relaxed);
+    });
+
+    // link each vertex to its first few neighbors only
+    const int neighborRounds = 2;
+    for(int r = 0; r < neighborRounds; r++)
+    {
+        parallelFor(0, n, threads, [&](long long v)
+        {
+            if(offsets[v] + r < offsets[v + 1])
+                impl_::Components__link(parent, v, targets[offsets[v] + r]);
+        });
+        impl_::Components__compress(parent, threads);
+    }
+
+    // then everything else, except from inside the largest component
+    int largest = impl_::Components__largest(parent);
+    CSRGraph transposed = g.transpose();
+    const CSRArray<int>& inOffsets = transposed.offsets();
+    const CSRArray<int>& inSources = transposed.targets();
+
+    parallelFor(0, n, threads, [&](long long v)
+    {
+        if(parent[v].load(std::memory_order_relaxed) == largest)
+            return;
+        for(int i = offsets[v] + neighborRounds; i < offsets[v + 1]; i++)
+            impl_::Components__link(parent, v, targets[i]);
+        for(int i = inOffsets[v]; i < inOffsets[v + 1]; i++)
+            impl_::Components__link(parent, v, inSources[i]);
+    });
+    impl_::Components__compress(parent, threads);
+
+    std::vector<int> component(n);
+    for(int v = 0; v < n; v++)
+        component[v] = parent[v].load(std::memory_order_relaxed);
+    return component;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> weaklyConnectedComponents(
+    const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads)
+{
+    CSRGraph g{d};
+    std::vector<int> component = weaklyConnectedComponents(g, threads);
+
+    std::map<int, int> ans;
+    for(int i = 0; i < g.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), g.vertexNumber(i), g.vertexNumber(component[i]));
+    return ans;
+}
+
+
+
+#endif // CONNECTEDCOMPONENTS_HPP
@@ -0,0 +1,792 @@
+// ContractionHierarchies.hpp
+//
+//
+// A ContractionHierarchies object is a preprocessed, read-only copy of
+// a Digraph that answers point-to-point shortest path queries far faster
+// than running Dijkstra's algorithm on the Digraph itself.
+//
+// Preprocessing ranks every vertex by "importance" and then contracts
+// the vertices one at a time from least to most important.  Contracting
+// a vertex v removes it from the remaining graph, and for every pair of
+// remaining neighbors u -> v -> w whose shortest connection runs through
+// v, a "shortcut" edge u -> w is inserted that remembers v as its middle
+// vertex.  Afterward, every shortest path can be found by a bidirectional
+// search that only ever moves "upward" to more important vertices, which
+// typically settles a few hundred vertices even on very large graphs.
+//
+// The hierarchy can be written to and read back from a binary stream,
+// so preprocessing can be done once and shared across processes.
+//
+
+#ifndef CONTRACTIONHIERARCHIES_HPP
+#define CONTRACTIONHIERARCHIES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+class ContractionHierarchies
+{
+public:
+    // Builds the hierarchy for the given Digraph.  edgeWeightFunc takes
+    // an EdgeInfo object and determines an edge weight, exactly as in
+    // Digraph::findShortestPaths(); weights must not be negative.
+    template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+    ContractionHierarchies(const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc);
+
+    // distance() returns the length of a shortest path from the "from"
+    // vertex to the "to" vertex, or infinity if there is no such path.
+    // If either vertex does not exist, a DigraphException is thrown.
+    double distance(int fromVertex, int toVertex) const;
+
+    // path() returns the sequence of vertex numbers along a shortest
+    // path from the "from" vertex to the "to" vertex (both included),
+    // with every shortcut unpacked into the original edges, or an empty
+    // std::vector if there is no such path.  If either vertex does not
+    // exist, a DigraphException is thrown.
+    std::vector<int> path(int fromVertex, int toVertex) const;
+
+    // vertexCount() returns the number of vertices in the hierarchy.
+    int vertexCount() const noexcept;
+
+    // arcCount() returns the number of upward arcs stored, including
+    // shortcuts, across both search directions.
+    int arcCount() const noexcept;
+
+    // save() writes the hierarchy to the given stream in a versioned
+    // binary format that load() can read back.
+    void save(std::ostream& out) const;
+
+    // load() reads a hierarchy written by save().  If the stream does not
+    // contain a hierarchy in a supported format, a DigraphException is
+    // thrown instead.
+    static ContractionHierarchies load(std::istream& in);
+
+private:
+    // An Arc is an edge in one of the upward search graphs.  middle is
+    // the dense id of the contracted vertex a shortcut bypasses, or -1
+    // for an original edge of the Digraph.
+    struct Arc
+    {
+        int target;
+        double weight;
+        int middle;
+    };
+
+    // A WorkEdge is an edge of the shrinking graph used during
+    // preprocessing.
+    struct WorkEdge
+    {
+        int other;
+        double weight;
+        int middle;
+    };
+
+    static constexpr std::uint32_t MAGIC = 0x48434744;   // "DGCH"
+    static constexpr std::uint32_t VERSION = 2;
+
+    // Scratch state for the witness searches run while contracting; heap
+    // is a binary heap ordered by Compare, kept so that its storage is
+    // reused by every search.
+    struct WitnessScratch
+    {
+        std::vector<double> dist;
+        std::vector<int> hops;
+        std::vector<bool> isTarget;
+        std::vector<int> reached;
+        std::vector<std::pair<double,int>> heap;
+    };
+
+    // Caps on each witness search while contracting, on the vertices
+    // settled and on the edges in a witness path; a search that stops
+    // early just means an unneeded shortcut may be added, never a wrong one.
+    static constexpr int WITNESS_SETTLE_LIMIT = 500;
+    static constexpr int WITNESS_SIMULATE_LIMIT = 50;
+    static constexpr int WITNESS_HOP_LIMIT = 5;
+    static constexpr int WITNESS_SIMULATE_HOP_LIMIT = 2;
+
+private:
+    ContractionHierarchies() = default;
+
+    void build(std::vector<std::vector<WorkEdge>>& out, std::vector<std::vector<WorkEdge>>& in);
+
+    int contract(int v, bool simulate,
+                 const std::vector<std::vector<WorkEdge>>& out,
+                 const std::vector<std::vector<WorkEdge>>& in,
+                 WitnessScratch& scratch,
+                 std::vector<std::pair<std::pair<int, int>, WorkEdge>>* shortcuts);
+
+    static void addWorkEdge(std::vector<WorkEdge>& edges, int other, double weight, int middle);
+
+    static void removeWorkEdge(std::vector<WorkEdge>& edges, int other);
+
+    int denseId(int vertex) const;
+
+    double search(int s, int t, int& meeting) const;
+
+    void unpack(int u, int w, std::vector<int>& path) const;
+
+    const Arc* findArc(int u, int w) const;
+
+private:
+    std::vector<int> vertexNumbers;        // dense id -> vertex number
+    std::map<int, int> denseIds;           // vertex number -> dense id
+    std::vector<int> rank;
+
+    std::vector<int> fwdFirst;             // CSR offsets, size n + 1
+    std::vector<Arc> fwdArcs;              // u -> target, rank[target] > rank[u]
+    std::vector<int> bwdFirst;
+    std::vector<Arc> bwdArcs;              // target -> u, rank[target] > rank[u]
+
+    // scratch buffers reused across calls; a ContractionHierarchies is
+    // therefore not safe to query from several threads at once.
+    mutable std::vector<double> distFwd;
+    mutable std::vector<double> distBwd;
+    mutable std::vector<int> parentFwd;
+    mutable std::vector<int> parentBwd;
+    mutable std::vector<int> touched;
+};
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+ContractionHierarchies::ContractionHierarchies(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc)
+{
+    vertexNumbers = d.vertices();
+    for(int i = 0; i < static_cast<int>(vertexNumbers.size()); i++)
+        denseIds[vertexNumbers[i]] = i;
+
+    int n = vertexNumbers.size();
+    std::vector<std::vector<WorkEdge>> out(n);
+    std::vector<std::vector<WorkEdge>> in(n);
+
+    for(int u = 0; u < n; u++)
+    {
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertexNumbers[u]))
+        {
+            int w = denseIds.at(e.toVertex);
+            if(w == u)
+                continue;
+            double weight = edgeWeightFunc(e.einfo);
+            addWorkEdge(out[u], w, weight, -1);
+            addWorkEdge(in[w], u, weight, -1);
+        }
+    }
+
+    build(out, in);
+}
+
+
+inline void ContractionHierarchies::build(
+    std::vector<std::vector<WorkEdge>>& out, std::vector<std::vector<WorkEdge>>& in)
+{
+    int n = vertexNumbers.size();
+    rank.assign(n, 0);
+
+    WitnessScratch scratch;
+    scratch.dist.assign(n, std::numeric_limits<double>::infinity());
+    scratch.hops.assign(n, 0);
+    scratch.isTarget.assign(n, false);
+
+    // when a vertex is contracted, every edge it still has leads to a
+    // more important vertex, so those edges are exactly its upward arcs
+    std::vector<std::vector<Arc>> fwdLists(n);
+    std::vector<std::vector<Arc>> bwdLists(n);
+
+    std::vector<bool> contracted(n, false);
+    std::vector<int> currentPriority(n, 0);
+
+    // depth[v] bounds how many contracted vertices lie below v on a chain
+    // of upward arcs; adding it to the edge difference spreads the
+    // contractions evenly over the graph, which keeps the shortcuts and the
+    // query search spaces small
+    std::vector<int> depth(n, 0);
+
+    auto priority = [&](int v)
+    {
+        int added = contract(v, true, out, in, scratch, nullptr);
+        int removed = out[v].size() + in[v].size();
+        return added - removed + depth[v];
+    };
+
+    // entries whose priority no longer matches currentPriority are stale
+    // and skipped when popped
+    std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int>>,
+                        std::greater<std::pair<int,int>>> order;
+    auto updatePriority = [&](int v)
+    {
+        currentPriority[v] = priority(v);
+        order.push({currentPriority[v], v});
+    };
+
+    for(int v = 0; v < n; v++)
+        updatePriority(v);
+
+    int nextRank = 0;
+    std::vector<std::pair<std::pair<int, int>, WorkEdge>> shortcuts;
+    std::vector<int> neighbors;
+    while(!order.empty())
+    {
+        int v = order.top().second;
+        int stored = order.top().first;
+        order.pop();
+        if(contracted[v] || stored != currentPriority[v])
+            continue;
+
+        // lazy update: the priority may have drifted since it was last
+        // computed, so recompute it and put the vertex back if it is no
+        // longer the minimum
+        int p = priority(v);
+        if(p != stored)
+        {
+            currentPriority[v] = p;
+            if(!order.empty() && p > order.top().first)
+            {
+                order.push({p, v});
+                continue;
+            }
+        }
+
+        shortcuts.clear();
+        contract(v, false, out, in, scratch, &shortcuts);
+        contracted[v] = true;
+        rank[v] = nextRank++;
+
+        for(const WorkEdge& e : out[v])
+        {
+            fwdLists[v].push_back(Arc{e.other, e.weight, e.middle});
+            removeWorkEdge(in[e.other], v);
+            depth[e.other] = std::max(depth[e.other], depth[v] + 1);
+        }
+        for(const WorkEdge& e : in[v])
+        {
+            bwdLists[v].push_back(Arc{e.other, e.weight, e.middle});
+            removeWorkEdge(out[e.other], v);
+            depth[e.other] = std::max(depth[e.other], depth[v] + 1);
+        }
+        std::vector<WorkEdge>().swap(out[v]);
+        std::vector<WorkEdge>().swap(in[v]);
+
+        for(const auto& s : shortcuts)
+        {
+            addWorkEdge(out[s.first.first], s.first.second, s.second.weight, v);
+            addWorkEdge(in[s.first.second], s.first.first, s.second.weight, v);
+        }
+
+        // the neighbors' priorities changed the most, so refresh them now,
+        // once each even when an edge leads both ways
+        neighbors.clear();
+        for(const Arc& a : fwdLists[v])
+            neighbors.push_back(a.target);
+        for(const Arc& a : bwdLists[v])
+            neighbors.push_back(a.target);
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for(int w : neighbors)
+            updatePriority(w);
+    }
+
+    fwdFirst.assign(n + 1, 0);
+    bwdFirst.assign(n + 1, 0);
+    fwdArcs.clear();
+    bwdArcs.clear();
+    for(int v = 0; v < n; v++)
+    {
+        fwdArcs.insert(fwdArcs.end(), fwdLists[v].begin(), fwdLists[v].end());
+        bwdArcs.insert(bwdArcs.end(), bwdLists[v].begin(), bwdLists[v].end());
+        fwdFirst[v + 1] = fwdArcs.size();
+        bwdFirst[v + 1] = bwdArcs.size();
+    }
+
+    distFwd.assign(n, std::numeric_limits<double>::infinity());
+    distBwd.assign(n, std::numeric_limits<double>::infinity());
+    parentFwd.assign(n, -1);
+    parentBwd.assign(n, -1);
+}
+
+
+// addWorkEdge() adds an edge to "other" into the given edge list, or
+// lowers the weight of the one already there, so that parallel edges
+// never accumulate during preprocessing.
+inline void ContractionHierarchies::addWorkEdge(
+    std::vector<WorkEdge>& edges, int other, double weight, int middle)
+{
+    for(WorkEdge& e : edges)
+    {
+        if(e.other == other)
+        {
+            if(weight < e.weight)
+            {
+                e.weight = weight;
+                e.middle = middle;
+            }
+            return;
+        }
+    }
+    edges.push_back(WorkEdge{other, weight, middle});
+}
+
+
+inline void ContractionHierarchies::removeWorkEdge(std::vector<WorkEdge>& edges, int other)
+{
+    for(int i = 0; i < static_cast<int>(edges.size()); i++)
+    {
+        if(edges[i].other == other)
+        {
+            edges[i] = edges.back();
+            edges.pop_back();
+            return;
+        }
+    }
+}
+
+
+// contract() finds the shortcuts needed to remove v from the remaining
+// graph and returns how many there are.  Unless simulating, the shortcuts
+// are appended to *shortcuts.  Simulations only estimate a priority, so
+// they use a much smaller witness search budget.  Each witness search is
+// also limited to paths of a few edges, as in Geisberger et al.; longer
+// witnesses are rare and not worth the time spent looking for them.
+inline int ContractionHierarchies::contract(
+    int v, bool simulate,
+    const std::vector<std::vector<WorkEdge>>& out,
+    const std::vector<std::vector<WorkEdge>>& in,
+    WitnessScratch& scratch,
+    std::vector<std::pair<std::pair<int, int>, WorkEdge>>* shortcuts)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    int settleLimit = simulate ? WITNESS_SIMULATE_LIMIT : WITNESS_SETTLE_LIMIT;
+    int hopLimit = simulate ? WITNESS_SIMULATE_HOP_LIMIT : WITNESS_HOP_LIMIT;
+    std::vector<std::pair<double,int>>& heap = scratch.heap;
+    int count = 0;
+
+    for(const WorkEdge& outEdge : out[v])
+        scratch.isTarget[outEdge.other] = true;
+
+    for(const WorkEdge& inEdge : in[v])
+    {
+        int u = inEdge.other;
+
+        double maxVia = 0.0;
+        int targets = 0;
+        for(const WorkEdge& outEdge : out[v])
+        {
+            if(outEdge.other != u)
+            {
+                maxVia = std::max(maxVia, inEdge.weight + outEdge.weight);
+                targets++;
+            }
+        }
+        if(targets == 0)
+            continue;
+
+        // witness search: a bounded Dijkstra from u that avoids v, which
+        // stops once every target is settled or nothing closer than the
+        // longest path through v remains
+        heap.clear();
+        scratch.dist[u] = 0.0;
+        scratch.hops[u] = 0;
+        scratch.reached.push_back(u);
+        heap.push_back({0.0, u});
+        int settled = 0;
+        int targetsSettled = 0;
+        while(!heap.empty() && settled < settleLimit && targetsSettled < targets)
+        {
+            std::pair<double,int> top = heap.front();
+            std::pop_heap(heap.begin(), heap.end(), Compare{});
+            heap.pop_back();
+            if(top.first > scratch.dist[top.second])
+                continue;
+            if(top.first > maxVia)
+                break;
+            settled++;
+            if(scratch.isTarget[top.second] && top.second != u)
+                targetsSettled++;
+            if(scratch.hops[top.second] == hopLimit)
+                continue;
+            for(const WorkEdge& e : out[top.second])
+            {
+                if(e.other == v)
+                    continue;
+                double nd = top.first + e.weight;
+                if(nd <= maxVia && nd < scratch.dist[e.other])
+                {
+                    if(scratch.dist[e.other] == infinity)
+                        scratch.reached.push_back(e.other);
+                    scratch.dist[e.other] = nd;
+                    scratch.hops[e.other] = scratch.hops[top.second] + 1;
+                    heap.push_back({nd, e.other});
+                    std::push_heap(heap.begin(), heap.end(), Compare{});
+                }
+            }
+        }
+
+        for(const WorkEdge& outEdge : out[v])
+        {
+            int w = outEdge.other;
+            if(w == u)
+                continue;
+            double via = inEdge.weight + outEdge.weight;
+            if(scratch.dist[w] > via)
+            {
+                count++;
+                if(!simulate)
+                    shortcuts->push_back({{u, w}, WorkEdge{w, via, v}});
+            }
+        }
+
+        for(int r : scratch.reached)
+            scratch.dist[r] = infinity;
+        scratch.reached.clear();
+    }
+
+    for(const WorkEdge& outEdge : out[v])
+        scratch.isTarget[outEdge.other] = false;
+
+    return count;
+}
+
+
+inline int ContractionHierarchies::denseId(int vertex) const
+{
+    auto it = denseIds.find(vertex);
+    if(it == denseIds.end())
+        throw DigraphException{std::string("When ContractionHierarchies query, vertex not found!")};
+    return it->second;
+}
+
+
+// search() runs the bidirectional upward Dijkstra between dense ids s and
+// t, leaving the parent pointers of both searches in the scratch buffers.
+inline double ContractionHierarchies::search(int s, int t, int& meeting) const
+{
+    for(int v : touched)
+    {
+        distFwd[v] = distBwd[v] = std::numeric_limits<double>::infinity();
+        parentFwd[v] = parentBwd[v] = -1;
+    }
+    touched.clear();
+
+    typedef std::priority_queue<std::pair<double,int>, std::vector<std::pair<double,int>>, Compare> Queue;
+    Queue fwd, bwd;
+    distFwd[s] = 0.0;
+    distBwd[t] = 0.0;
+    touched.push_back(s);
+    touched.push_back(t);
+    fwd.push({0.0, s});
+    bwd.push({0.0, t});
+
+    double best = std::numeric_limits<double>::infinity();
+    meeting = -1;
+
+    auto step = [&](Queue& q, std::vector<double>& dist, std::vector<double>& otherDist,
+                    std::vector<int>& parent, const std::vector<int>& first, const std::vector<Arc>& arcs)
+    {
+        std::pair<double,int> top = q.top();
+        q.pop();
+        int v = top.second;
+        if(top.first > dist[v])
+            return;
+        if(dist[v] + otherDist[v] < best)
+        {
+            best = dist[v] + otherDist[v];
+            meeting = v;
+        }
+        for(int i = first[v]; i < first[v + 1]; i++)
+        {
+            const Arc& a = arcs[i];
+            double nd = dist[v] + a.weight;
+            if(nd < dist[a.target])
+            {
+                if(distFwd[a.target] == std::numeric_limits<double>::infinity()
+                   && distBwd[a.target] == std::numeric_limits<double>::infinity())
+                    touched.push_back(a.target);
+                dist[a.target] = nd;
+                parent[a.target] = v;
+                q.push({nd, a.target});
+            }
+        }
+    };
+
+    while(!fwd.empty() || !bwd.empty())
+    {
+        double fwdMin = fwd.empty() ? std::numeric_limits<double>::infinity() : fwd.top().first;
+        double bwdMin = bwd.empty() ? std::numeric_limits<double>::infinity() : bwd.top().first;
+        if(std::min(fwdMin, bwdMin) >= best)
+            break;
+        if(fwdMin <= bwdMin)
+            step(fwd, distFwd, distBwd, parentFwd, fwdFirst, fwdArcs);
+        else
+            step(bwd, distBwd, distFwd, parentBwd, bwdFirst, bwdArcs);
+    }
+
+    return best;
+}
+
+
+inline double ContractionHierarchies::distance(int fromVertex, int toVertex) const
+{
+    int s = denseId(fromVertex);
+    int t = denseId(toVertex);
+    int meeting;
+    return search(s, t, meeting);
+}
+
+
+inline std::vector<int> ContractionHierarchies::path(int fromVertex, int toVertex) const
+{
+    int s = denseId(fromVertex);
+    int t = denseId(toVertex);
+    int meeting;
+    std::vector<int> result;
+    if(search(s, t, meeting) == std::numeric_limits<double>::infinity())
+        return result;
+
+    std::vector<int> up;
+    for(int v = meeting; v != -1; v = parentFwd[v])
+        up.push_back(v);
+    std::reverse(up.begin(), up.end());
+    for(int v = parentBwd[meeting]; v != -1; v = parentBwd[v])
+        up.push_back(v);
+
+    std::vector<int> dense{up[0]};
+    for(int i = 0; i + 1 < static_cast<int>(up.size()); i++)
+        unpack(up[i], up[i + 1], dense);
+
+    for(int v : dense)
+        result.push_back(vertexNumbers[v]);
+    return result;
+}
+
+
+// findArc() returns the cheapest stored arc representing the edge u -> w.
+inline const ContractionHierarchies::Arc* ContractionHierarchies::findArc(int u, int w) const
+{
+    const Arc* best = nullptr;
+    if(rank[w] > rank[u])
+    {
+        for(int i = fwdFirst[u]; i < fwdFirst[u + 1]; i++)
+            if(fwdArcs[i].target == w && (best == nullptr || fwdArcs[i].weight < best->weight))
+                best = &fwdArcs[i];
+    }
+    else
+    {
+        for(int i = bwdFirst[w]; i < bwdFirst[w + 1]; i++)
+            if(bwdArcs[i].target == u && (best == nullptr || bwdArcs[i].weight < best->weight))
+                best = &bwdArcs[i];
+    }
+    return best;
+}
+
+
+// unpack() appends the vertices after u on the original-edge path that
+// the (possibly shortcut) edge u -> w stands for.
+inline void ContractionHierarchies::unpack(int u, int w, std::vector<int>& path) const
+{
+    const Arc* a = findArc(u, w);
+    if(a == nullptr)
+        throw DigraphException{std::string("When ContractionHierarchies path, shortcut can't be unpacked!")};
+    if(a->middle == -1)
+    {
+        path.push_back(w);
+        return;
+    }
+    unpack(u, a->middle, path);
+    unpack(a->middle, w, path);
+}
+
+
+inline int ContractionHierarchies::vertexCount() const noexcept
+{
+    return vertexNumbers.size();
+}
+
+
+inline int ContractionHierarchies::arcCount() const noexcept
+{
+    return fwdArcs.size() + bwdArcs.size();
+}
+
+
+namespace impl_
+{
+    template <typename T>
+    void ContractionHierarchies__write(std::ostream& out, const std::vector<T>& v)
+    {
+        std::uint64_t sz = v.size();
+        out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
+        out.write(reinterpret_cast<const char*>(v.data()), sz * sizeof(T));
+    }
+
+    // ContractionHierarchies__read() reads a vector written by
+    // ContractionHierarchies__write(), a block at a time, so that a
+    // corrupt size runs out of stream before it runs out of memory.
+    template <typename T>
+    void ContractionHierarchies__read(std::istream& in, std::vector<T>& v)
+    {
+        std::uint64_t sz = 0;
+        in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
+        if(!in)
+            throw DigraphException{std::string("When ContractionHierarchies load, stream truncated!")};
+        v.clear();
+        const std::uint64_t block = 1 << 16;
+        for(std::uint64_t done = 0; done < sz; )
+        {
+            std::uint64_t count = std::min(block, sz - done);
+            v.resize(done + count);
+            in.read(reinterpret_cast<char*>(v.data() + done), count * sizeof(T));
+            if(!in)
+                throw DigraphException{std::string("When ContractionHierarchies load, stream truncated!")};
+            done += count;
+        }
+    }
+
+    // Arcs are written field by field, since the padding inside the struct
+    // is uninitialized and its layout is up to the compiler.
+    template <typename Arc>
+    void ContractionHierarchies__writeArcs(std::ostream& out, const std::vector<Arc>& arcs)
+    {
+        std::vector<std::int32_t> targets, middles;
+        std::vector<double> weights;
+        for(const Arc& a : arcs)
+        {
+            targets.push_back(a.target);
+            weights.push_back(a.weight);
+            middles.push_back(a.middle);
+        }
+        ContractionHierarchies__write(out, targets);
+        ContractionHierarchies__write(out, weights);
+        ContractionHierarchies__write(out, middles);
+    }
+
+    template <typename Arc>
+    void ContractionHierarchies__readArcs(std::istream& in, std::vector<Arc>& arcs)
+    {
+        std::vector<std::int32_t> targets, middles;
+        std::vector<double> weights;
+        ContractionHierarchies__read(in, targets);
+        ContractionHierarchies__read(in, weights);
+        ContractionHierarchies__read(in, middles);
+        if(weights.size() != targets.size() || middles.size() != targets.size())
+            throw DigraphException{std::string("When ContractionHierarchies load, inconsistent sizes!")};
+
+        arcs.clear();
+        arcs.reserve(targets.size());
+        for(std::size_t i = 0; i < targets.size(); i++)
+            arcs.push_back(Arc{targets[i], weights[i], middles[i]});
+    }
+
+    // ContractionHierarchies__checkFirst() returns true if first holds
+    // valid CSR offsets into arcCount arcs: starting at 0, never
+    // decreasing and ending at arcCount.
+    inline bool ContractionHierarchies__checkFirst(const std::vector<int>& first, std::size_t arcCount)
+    {
+        if(first.empty() || first.front() != 0 || static_cast<std::size_t>(first.back()) != arcCount)
+            return false;
+        for(std::size_t i = 1; i < first.size(); i++)
+            if(first[i] < first[i - 1])
+                return false;
+        return true;
+    }
+
+    // ContractionHierarchies__checkArcs() returns true if every arc leaves
+    // its vertex upward to a vertex of higher rank, and every shortcut
+    // bypasses a vertex ranked below both ends, so that unpacking it
+    // terminates.  first must already have passed
+    // ContractionHierarchies__checkFirst().
+    template <typename Arc>
+    bool ContractionHierarchies__checkArcs(
+        const std::vector<int>& first, const std::vector<Arc>& arcs, const std::vector<int>& rank)
+    {
+        int n = rank.size();
+        for(int u = 0; u < n; u++)
+        {
+            for(int i = first[u]; i < first[u + 1]; i++)
+            {
+                const Arc& a = arcs[i];
+                if(a.target < 0 || a.target >= n || rank[a.target] <= rank[u])
+                    return false;
+                if(a.middle != -1 && (a.middle < 0 || a.middle >= n || rank[a.middle] >= rank[u]))
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+inline void ContractionHierarchies::save(std::ostream& out) const
+{
+    std::uint32_t header[2] = {MAGIC, VERSION};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    impl_::ContractionHierarchies__write(out, vertexNumbers);
+    impl_::ContractionHierarchies__write(out, rank);
+    impl_::ContractionHierarchies__write(out, fwdFirst);
+    impl_::ContractionHierarchies__writeArcs(out, fwdArcs);
+    impl_::ContractionHierarchies__write(out, bwdFirst);
+    impl_::ContractionHierarchies__writeArcs(out, bwdArcs);
+}
+
+
+inline ContractionHierarchies ContractionHierarchies::load(std::istream& in)
+{
+    std::uint32_t header[2] = {0, 0};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if(!in || header[0] != MAGIC)
+        throw DigraphException{std::string("When ContractionHierarchies load, not a hierarchy file!")};
+    if(header[1] != VERSION)
+        throw DigraphException{std::string("When ContractionHierarchies load, unsupported version!")};
+
+    ContractionHierarchies ch;
+    impl_::ContractionHierarchies__read(in, ch.vertexNumbers);
+    impl_::ContractionHierarchies__read(in, ch.rank);
+    impl_::ContractionHierarchies__read(in, ch.fwdFirst);
+    impl_::ContractionHierarchies__readArcs(in, ch.fwdArcs);
+    impl_::ContractionHierarchies__read(in, ch.bwdFirst);
+    impl_::ContractionHierarchies__readArcs(in, ch.bwdArcs);
+
+    int n = ch.vertexNumbers.size();
+    if(static_cast<int>(ch.rank.size()) != n || static_cast<int>(ch.fwdFirst.size()) != n + 1
+       || static_cast<int>(ch.bwdFirst.size()) != n + 1)
+        throw DigraphException{std::string("When ContractionHierarchies load, inconsistent sizes!")};
+    if(!impl_::ContractionHierarchies__checkFirst(ch.fwdFirst, ch.fwdArcs.size())
+       || !impl_::ContractionHierarchies__checkFirst(ch.bwdFirst, ch.bwdArcs.size()))
+        throw DigraphException{std::string("When ContractionHierarchies load, bad arc offsets!")};
+
+    std::vector<bool> seen(n, false);
+    for(int r : ch.rank)
+    {
+        if(r < 0 || r >= n || seen[r])
+            throw DigraphException{std::string("When ContractionHierarchies load, rank is not a permutation!")};
+        seen[r] = true;
+    }
+
+    if(!impl_::ContractionHierarchies__checkArcs(ch.fwdFirst, ch.fwdArcs, ch.rank)
+       || !impl_::ContractionHierarchies__checkArcs(ch.bwdFirst, ch.bwdArcs, ch.rank))
+        throw DigraphException{std::string("When ContractionHierarchies load, arc out of range!")};
+
+    for(int i = 0; i < n; i++)
+        ch.denseIds[ch.vertexNumbers[i]] = i;
+    if(static_cast<int>(ch.denseIds.size()) != n)
+        throw DigraphException{std::string("When ContractionHierarchies load, repeated vertex number!")};
+    ch.distFwd.assign(n, std::numeric_limits<double>::infinity());
+    ch.distBwd.assign(n, std::numeric_limits<double>::infinity());
+    ch.parentFwd.assign(n, -1);
+    ch.parentBwd.assign(n, -1);
+    return ch;
+}
+
+
+
+#endif // CONTRACTIONHIERARCHIES_HPP
@@ -0,0 +1,266 @@
+// DeltaStepping.hpp
+//
+//
+// A multi-threaded single-source shortest path algorithm ("delta-stepping",
+// Meyer and Sanders) over a CSRGraph snapshot.
+//
+// Vertices are kept in buckets of width delta by tentative distance, and
+// the buckets are processed in increasing order.  All vertices in the
+// current bucket are relaxed at once, in parallel; edges no heavier than
+// delta ("light" edges) can put vertices back into the current bucket,
+// so it is repeated until it stays empty, after which the "heavy" edges
+// of everything removed from it are relaxed once.  A small delta behaves
+// like Dijkstra's algorithm, a large one like Bellman-Ford.
+//
+// No tentative distance is ever more than the largest edge weight beyond
+// the current bucket, so only that many buckets are kept, reused
+// cyclically.
+//
+// Each vertex is owned by one thread (by index modulo the thread count),
+// and only that thread ever writes its distance, predecessor, or bucket
+// entries; other threads send it relaxation requests instead, so no
+// atomics or locks are needed beyond a barrier between phases.
+//
+
+#ifndef DELTASTEPPING_HPP
+#define DELTASTEPPING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// A ShortestPathTree holds the result of a single-source shortest path
+// computation on a CSRGraph, indexed by dense vertex index.  Following
+// the convention of Digraph::findShortestPaths(), the predecessor of the
+// start vertex and of every unreached vertex is the vertex itself; an
+// unreached vertex also has an infinite distance.
+struct ShortestPathTree
+{
+    std::vector<double> distance;
+    std::vector<int> predecessor;
+};
+
+
+// deltaStepping() computes shortest paths from the vertex with the given
+// vertex number in a weighted CSRGraph.  A delta of zero or less picks
+// one from the weights (the largest weight divided by the average
+// degree), and a thread count of zero uses one per hardware thread.  A
+// delta so small that the largest weight spans more buckets than there
+// are vertices (or 64, if that is more) is raised to fit.  Edges of
+// infinite weight are never followed.  If the snapshot has no weights,
+// has a negative or NaN weight, or does not contain the start vertex, a
+// DigraphException is thrown instead.
+ShortestPathTree deltaStepping(
+    const CSRGraph& g, int startVertex, double delta = 0.0, unsigned int threads = 0);
+
+
+// findShortestPathsParallel() is a drop-in, multi-threaded counterpart to
+// Digraph::findShortestPaths(): it snapshots the Digraph, runs
+// deltaStepping(), and returns the predecessor of every vertex keyed by
+// vertex number.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> findShortestPathsParallel(
+    const Digraph<VertexInfo, EdgeInfo>& d, int startVertex, EdgeWeightFunc edgeWeightFunc,
+    double delta = 0.0, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    struct DeltaStepping__Request
+    {
+        int vertex;
+        double distance;
+        int predecessor;
+    };
+}
+
+
+inline ShortestPathTree deltaStepping(
+    const CSRGraph& g, int startVertex, double delta, unsigned int threads)
+{
+    int n = g.vertexCount();
+    int start = g.indexOf(startVertex);
+    if(!g.hasWeights())
+        throw DigraphException{std::string("When deltaStepping, graph has no weights!")};
+
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+    const CSRArray<double>& weights = g.weights();
+
+    double maxWeight = 0.0;
+    for(double w : weights)
+    {
+        if(w < 0.0)
+            throw DigraphException{std::string("When deltaStepping, negative edge weight!")};
+        if(w != w)
+            throw DigraphException{std::string("When deltaStepping, edge weight is NaN!")};
+        if(w != std::numeric_limits<double>::infinity())
+            maxWeight = std::max(maxWeight, w);
+    }
+    if(delta <= 0.0)
+    {
+        double averageDegree = n == 0 ? 1.0 : std::max(1.0, double(g.edgeCount()) / n);
+        delta = maxWeight > 0.0 ? maxWeight / averageDegree : 1.0;
+    }
+
+    // a live distance lies at most maxWeight beyond the current bucket, so
+    // bucketCount buckets, used cyclically, always tell them apart (with
+    // one to spare for rounding)
+    const std::size_t maxBuckets = std::max(n, 64);
+    if(maxWeight / delta > maxBuckets - 3)
+        delta = maxWeight / (maxBuckets - 3);
+    const std::size_t bucketCount = static_cast<std::size_t>(maxWeight / delta) + 3;
+
+    threads = std::min<unsigned int>(resolveThreadCount(threads), std::max(n, 1));
+
+    ShortestPathTree result;
+    result.distance.assign(n, std::numeric_limits<double>::infinity());
+    result.predecessor.resize(n);
+    for(int i = 0; i < n; i++)
+        result.predecessor[i] = i;
+
+    std::vector<double>& dist = result.distance;
+    std::vector<int>& pred = result.predecessor;
+
+    typedef impl_::DeltaStepping__Request Request;
+    const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    // buckets[t][b % bucketCount] holds vertices owned by thread t whose
+    // distance was put in bucket b; entries go stale when a distance drops
+    // further
+    std::vector<std::vector<std::vector<int>>> buckets(
+        threads, std::vector<std::vector<int>>(bucketCount));
+    // outbox[s][t] holds requests from thread s for vertices thread t owns
+    std::vector<std::vector<std::vector<Request>>> outbox(
+        threads, std::vector<std::vector<Request>>(threads));
+    std::vector<std::size_t> nextBucket(threads);
+    std::vector<char> nonEmpty(threads);
+    std::vector<char> settled(n, false);
+    Barrier barrier{threads};
+
+    dist[start] = 0.0;
+    buckets[start % threads][0].push_back(start);
+
+    auto bucketOf = [&](double d) { return static_cast<std::size_t>(d / delta); };
+
+    runThreads(threads, [&](unsigned int t)
+    {
+        std::vector<std::vector<int>>& myBuckets = buckets[t];
+        std::vector<int> frontier;
+        std::vector<int> removed;
+
+        auto request = [&](int v, bool light)
+        {
+            for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                if((weights[i] <= delta) == light)
+                {
+                    int w = targets[i];
+                    outbox[t][w % threads].push_back(Request{w, dist[v] + weights[i], v});
+                }
+            }
+        };
+
+        auto apply = [&]()
+        {
+            barrier.wait();
+            for(unsigned int s = 0; s < threads; s++)
+            {
+                for(const Request& r : outbox[s][t])
+                {
+                    if(r.distance < dist[r.vertex])
+                    {
+                        dist[r.vertex] = r.distance;
+                        pred[r.vertex] = r.predecessor;
+                        myBuckets[bucketOf(r.distance) % bucketCount].push_back(r.vertex);
+                    }
+                }
+            }
+            barrier.wait();
+            for(unsigned int s = 0; s < threads; s++)
+                outbox[t][s].clear();
+        };
+
+        std::size_t current = 0;
+        while(true)
+        {
+            std::size_t mine = NONE;
+            for(std::size_t b = current; b < current + bucketCount; b++)
+            {
+                if(!myBuckets[b % bucketCount].empty())
+                {
+                    mine = b;
+                    break;
+                }
+            }
+            nextBucket[t] = mine;
+            barrier.wait();
+            current = *std::min_element(nextBucket.begin(), nextBucket.end());
+            barrier.wait();
+            if(current == NONE)
+                break;
+
+            removed.clear();
+            while(true)
+            {
+                frontier.clear();
+                frontier.swap(myBuckets[current % bucketCount]);
+
+                for(int v : frontier)
+                {
+                    if(bucketOf(dist[v]) != current)
+                        continue;
+                    if(!settled[v])
+                    {
+                        settled[v] = true;
+                        removed.push_back(v);
+                    }
+                    request(v, true);
+                }
+                apply();
+
+                nonEmpty[t] = !myBuckets[current % bucketCount].empty();
+                barrier.wait();
+                bool again = std::find(nonEmpty.begin(), nonEmpty.end(), true) != nonEmpty.end();
+                barrier.wait();
+                if(!again)
+                    break;
+            }
+
+            for(int v : removed)
+                request(v, false);
+            apply();
+
+            current++;
+        }
+    });
+
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> findShortestPathsParallel(
+    const Digraph<VertexInfo, EdgeInfo>& d, int startVertex, EdgeWeightFunc edgeWeightFunc,
+    double delta, unsigned int threads)
+{
+    CSRGraph g{d, edgeWeightFunc};
+    ShortestPathTree tree = deltaStepping(g, startVertex, delta, threads);
+
+    std::map<int, int> ans;
+    for(int i = 0; i < g.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), g.vertexNumber(i), g.vertexNumber(tree.predecessor[i]));
+    return ans;
+}
+
+
+
+#endif // DELTASTEPPING_HPP
@@ -26,8 +26,12 @@
 #include <utility>
 #include <vector>
 #include <iostream>
+#include <cstddef>
+#include <iterator>
 #include <limits>
 #include <queue>
+#include <unordered_map>
+#include <algorithm>
 
 // DigraphExceptions are thrown from some of the member functions in the
 // Digraph class template, so that exception is declared here, so it
@@ -75,6 +79,257 @@ struct DigraphVertex
 
 
 
+// A DigraphRange is a pair of iterators that can be used in a range-based
+// for loop.  Digraph returns DigraphRanges from its "view" member functions
+// so that callers can walk vertices and edges in place, without anything
+// being copied into a freshly allocated std::vector.  A DigraphRange is
+// only valid until the Digraph it came from is next modified.
+
+template <typename Iterator>
+class DigraphRange
+{
+public:
+    using iterator_type = Iterator;
+
+    DigraphRange(Iterator first, Iterator last);
+
+    Iterator begin() const;
+    Iterator end() const;
+    bool empty() const;
+
+private:
+    Iterator first;
+    Iterator last;
+};
+
+
+template <typename Iterator>
+DigraphRange<Iterator>::DigraphRange(Iterator first, Iterator last)
+    : first{first}, last{last}
+{
+}
+
+
+template <typename Iterator>
+Iterator DigraphRange<Iterator>::begin() const
+{
+    return first;
+}
+
+
+template <typename Iterator>
+Iterator DigraphRange<Iterator>::end() const
+{
+    return last;
+}
+
+
+template <typename Iterator>
+bool DigraphRange<Iterator>::empty() const
+{
+    return first == last;
+}
+
+
+
+// A DigraphVertexIterator walks the vertex numbers of a Digraph in
+// increasing order, reading them straight out of the Digraph's map.
+
+template <typename MapIterator>
+class DigraphVertexIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int*;
+    using reference = const int&;
+
+    DigraphVertexIterator() = default;
+    explicit DigraphVertexIterator(MapIterator it);
+
+    reference operator*() const;
+    DigraphVertexIterator& operator++();
+    DigraphVertexIterator operator++(int);
+    bool operator==(const DigraphVertexIterator& other) const;
+    bool operator!=(const DigraphVertexIterator& other) const;
+
+private:
+    MapIterator it;
+};
+
+
+template <typename MapIterator>
+DigraphVertexIterator<MapIterator>::DigraphVertexIterator(MapIterator it)
+    : it{it}
+{
+}
+
+
+template <typename MapIterator>
+const int& DigraphVertexIterator<MapIterator>::operator*() const
+{
+    return it->first;
+}
+
+
+template <typename MapIterator>
+DigraphVertexIterator<MapIterator>& DigraphVertexIterator<MapIterator>::operator++()
+{
+    ++it;
+    return *this;
+}
+
+
+template <typename MapIterator>
+DigraphVertexIterator<MapIterator> DigraphVertexIterator<MapIterator>::operator++(int)
+{
+    DigraphVertexIterator old = *this;
+    ++it;
+    return old;
+}
+
+
+template <typename MapIterator>
+bool DigraphVertexIterator<MapIterator>::operator==(const DigraphVertexIterator& other) const
+{
+    return it == other.it;
+}
+
+
+template <typename MapIterator>
+bool DigraphVertexIterator<MapIterator>::operator!=(const DigraphVertexIterator& other) const
+{
+    return it != other.it;
+}
+
+
+
+// A DigraphEdgeIterator walks every edge of a Digraph, one vertex's edge
+// list after another, yielding references to the DigraphEdges themselves.
+
+template <typename MapIterator, typename ListIterator>
+class DigraphEdgeIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<ListIterator>::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::iterator_traits<ListIterator>::pointer;
+    using reference = typename std::iterator_traits<ListIterator>::reference;
+
+    DigraphEdgeIterator() = default;
+    DigraphEdgeIterator(MapIterator vertex, MapIterator vertexEnd);
+
+    reference operator*() const;
+    pointer operator->() const;
+    DigraphEdgeIterator& operator++();
+    DigraphEdgeIterator operator++(int);
+    bool operator==(const DigraphEdgeIterator& other) const;
+    bool operator!=(const DigraphEdgeIterator& other) const;
+
+private:
+    void skipEmptyLists();
+
+private:
+    MapIterator vertex;
+    MapIterator vertexEnd;
+    ListIterator edge;
+};
+
+
+template <typename MapIterator, typename ListIterator>
+DigraphEdgeIterator<MapIterator, ListIterator>::DigraphEdgeIterator(
+    MapIterator vertex, MapIterator vertexEnd)
+    : vertex{vertex}, vertexEnd{vertexEnd}
+{
+    if(vertex != vertexEnd)
+        edge = vertex->second.edges.begin();
+    skipEmptyLists();
+}
+
+
+template <typename MapIterator, typename ListIterator>
+void DigraphEdgeIterator<MapIterator, ListIterator>::skipEmptyLists()
+{
+    while(vertex != vertexEnd && edge == vertex->second.edges.end())
+    {
+        ++vertex;
+        if(vertex != vertexEnd)
+            edge = vertex->second.edges.begin();
+    }
+}
+
+
+template <typename MapIterator, typename ListIterator>
+typename DigraphEdgeIterator<MapIterator, ListIterator>::reference
+DigraphEdgeIterator<MapIterator, ListIterator>::operator*() const
+{
+    return *edge;
+}
+
+
+template <typename MapIterator, typename ListIterator>
+typename DigraphEdgeIterator<MapIterator, ListIterator>::pointer
+DigraphEdgeIterator<MapIterator, ListIterator>::operator->() const
+{
+    return &*edge;
+}
+
+
+template <typename MapIterator, typename ListIterator>
+DigraphEdgeIterator<MapIterator, ListIterator>& DigraphEdgeIterator<MapIterator, ListIterator>::operator++()
+{
+    ++edge;
+    skipEmptyLists();
+    return *this;
+}
+
+
+template <typename MapIterator, typename ListIterator>
+DigraphEdgeIterator<MapIterator, ListIterator> DigraphEdgeIterator<MapIterator, ListIterator>::operator++(int)
+{
+    DigraphEdgeIterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename MapIterator, typename ListIterator>
+bool DigraphEdgeIterator<MapIterator, ListIterator>::operator==(const DigraphEdgeIterator& other) const
+{
+    return vertex == other.vertex && (vertex == vertexEnd || edge == other.edge);
+}
+
+
+template <typename MapIterator, typename ListIterator>
+bool DigraphEdgeIterator<MapIterator, ListIterator>::operator!=(const DigraphEdgeIterator& other) const
+{
+    return !(*this == other);
+}
+
+
+
+// A BFSInfo describes one vertex reached by Digraph::breadthFirstSearch():
+// how many edges away from the start vertex it is, and which vertex it
+// was first reached from.
+
+struct BFSInfo
+{
+    int level;
+    int parent;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphBuilder;
+
+template <typename VertexInfo, typename EdgeInfo>
+class DynamicShortestPaths;
+
+
+
 // Digraph is a class template that represents a directed graph implemented
 // using adjacency lists.  It takes two type parameters:
 //
@@ -89,14 +344,46 @@ struct DigraphVertex
 template <typename VertexInfo, typename EdgeInfo>
 class Digraph
 {
+public:
+    // The types returned by the "view" member functions below.  A
+    // VertexView yields vertex numbers (as ints), while an EdgeView and an
+    // OutEdgeView yield const references to DigraphEdge<EdgeInfo> objects,
+    // which carry the "from" and "to" vertex numbers and the EdgeInfo.
+    using VertexView = DigraphRange<DigraphVertexIterator<
+        typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::const_iterator>>;
+    using EdgeView = DigraphRange<DigraphEdgeIterator<
+        typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::const_iterator,
+        typename std::list<DigraphEdge<EdgeInfo>>::const_iterator>>;
+    using OutEdgeView = DigraphRange<typename std::list<DigraphEdge<EdgeInfo>>::const_iterator>;
+
 public:
     // The default constructor initializes a new, empty Digraph so that
-    // contains no vertices and no edges.
+    // contains no vertices and no edges.  It keeps the outgoing edge
+    // index described below, but not the incoming one.
     Digraph();
 
+    // This constructor initializes a new, empty Digraph that can keep
+    // two per-vertex hash indexes.  Each costs a little time in addEdge()
+    // and removeEdge() and some memory per edge.
+    //
+    // * If indexInEdges is true, every vertex's incoming edges are
+    //   indexed, which makes removeVertex(), inEdges() and inDegree()
+    //   proportional to the degree of the vertex instead of the size of
+    //   the whole graph.
+    // * If indexOutEdges is true (the default), every vertex's outgoing
+    //   edges are indexed by "to" vertex number, which makes edgeInfo(),
+    //   removeEdge() and addEdge()'s check for an existing edge run in
+    //   constant time instead of time proportional to the vertex's
+    //   out-degree.
+    explicit Digraph(bool indexInEdges, bool indexOutEdges = true);
+
+    // The copy constructor initializes a new Digraph to be a separate,
+    // deep copy of an existing one, copying its vertices and edges in
+    // bulk rather than adding them one at a time.
     Digraph(const Digraph& d);
 
-    // The move constructor initializes a new Digraph from an expiring one.
+    // The move constructor initializes a new Digraph by taking over the
+    // contents of an expiring one in constant time, leaving it empty.
     Digraph(Digraph&& d) noexcept;
 
     // The destructor deallocates any memory associated with the Digraph.
@@ -109,9 +396,14 @@ public:
     Digraph& operator=(const Digraph& d);
 
     // The move assignment operator assigns the contents of an expiring
-    // Digraph into "this" Digraph.
+    // Digraph into "this" Digraph in constant time (aside from releasing
+    // what "this" Digraph held before), leaving the expiring one empty.
     Digraph& operator=(Digraph&& d) noexcept;
 
+    // swap() exchanges the contents of "this" Digraph with those of the
+    // given one in constant time.
+    void swap(Digraph& d) noexcept;
+
     // vertices() returns a std::vector containing the vertex numbers of
     // every vertex in this Digraph.
     std::vector<int> vertices() const;
@@ -128,16 +420,30 @@ public:
     // not exist, a DigraphException is thrown instead.
     std::vector<std::pair<int, int>> edges(int vertex) const;
 
-    // vertexInfo() returns the VertexInfo object belonging to the vertex
-    // with the given vertex number.  If that vertex does not exist, a
-    // DigraphException is thrown instead.
-    VertexInfo vertexInfo(int vertex) const;
+    // vertexView() is like vertices(), except that it returns a VertexView
+    // that reads the vertex numbers in place instead of copying them.
+    VertexView vertexView() const;
+
+    // edgeView() is like edges(), except that it returns an EdgeView over
+    // the edges themselves instead of copying their vertex numbers.
+    EdgeView edgeView() const;
+
+    // This overload of edgeView() is like edges(vertex), except that it
+    // returns an OutEdgeView over the given vertex's edge list in place.
+    // If the given vertex does not exist, a DigraphException is thrown
+    // instead.
+    OutEdgeView edgeView(int vertex) const;
 
-    // edgeInfo() returns the EdgeInfo object belonging to the edge
-    // with the given "from" and "to" vertex numbers.  If either of those
-    // vertices does not exist *or* if the edge does not exist, a
+    // vertexInfo() returns a reference to the VertexInfo object belonging
+    // to the vertex with the given vertex number.  If that vertex does not
+    // exist, a DigraphException is thrown instead.
+    const VertexInfo& vertexInfo(int vertex) const;
+
+    // edgeInfo() returns a reference to the EdgeInfo object belonging to
+    // the edge with the given "from" and "to" vertex numbers.  If either
+    // of those vertices does not exist *or* if the edge does not exist, a
     // DigraphException is thrown instead.
-    EdgeInfo edgeInfo(int fromVertex, int toVertex) const;
+    const EdgeInfo& edgeInfo(int fromVertex, int toVertex) const;
 
     // addVertex() adds a vertex to the Digraph with the given vertex
     // number and VertexInfo object.  If there is already a vertex in
@@ -148,8 +454,10 @@ public:
     // addEdge() adds an edge to the Digraph pointing from the given
     // "from" vertex number to the given "to" vertex number, and
     // associates with the given EdgeInfo object with it.  If one
-    // of the vertices does not exist *or* if the same edge is already
-    // present in the graph, a DigraphException is thrown instead.
+    // of the vertices does not exist, a DigraphException is thrown
+    // instead.  The same is true when the edge is already present in
+    // the graph, which takes constant time with either edge index and
+    // a scan of the "from" vertex's edges without one.
     void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
 
     // removeVertex() removes the vertex (and all of its incoming
@@ -165,6 +473,26 @@ public:
     // thrown instead.
     void removeEdge(int fromVertex, int toVertex);
 
+    // inEdges() returns a std::vector of std::pairs, in which each pair
+    // contains the "from" and "to" vertex numbers of an edge in this
+    // Digraph.  Only edges incoming to the given vertex number are
+    // included in the std::vector.  If the given vertex does not exist,
+    // a DigraphException is thrown instead.
+    std::vector<std::pair<int, int>> inEdges(int vertex) const;
+
+    // inDegree() returns the number of edges in the graph that are
+    // incoming to the given vertex number.  If the given vertex does
+    // not exist, a DigraphException is thrown instead.
+    int inDegree(int vertex) const;
+
+    // hasInEdgeIndex() returns true if this Digraph keeps an index of
+    // incoming edges, false otherwise.
+    bool hasInEdgeIndex() const noexcept;
+
+    // hasOutEdgeIndex() returns true if this Digraph keeps an index of
+    // outgoing edges, false otherwise.
+    bool hasOutEdgeIndex() const noexcept;
+
     // vertexCount() returns the number of vertices in the graph.
     int vertexCount() const noexcept;
 
@@ -192,16 +520,110 @@ public:
     // with each key k is the precedessor of that vertex chosen by
     // the algorithm.  For any vertex without a predecessor (e.g.,
     // a vertex that was never reached, or the start vertex itself),
-    // the value is simply a copy of the key.
+    // the value is simply a copy of the key.  Dijkstra's algorithm
+    // needs edge weights that aren't negative; if it comes across a
+    // negative one, a DigraphException is thrown (see BellmanFord.hpp
+    // for graphs that have them).
     std::map<int, int> findShortestPaths(
         int startVertex,
         std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
 
+    // aStar() finds a shortest path from the start vertex to the goal
+    // vertex using the A* search algorithm.  edgeWeightFunc takes an
+    // EdgeInfo object and determines an edge weight, exactly as in
+    // findShortestPaths().  heuristicFunc takes the VertexInfo of a
+    // vertex and the VertexInfo of the goal and returns an estimate of
+    // the remaining distance; as long as it never overestimates (and is
+    // consistent), the path found is a shortest one.  Both functions are
+    // template parameters, so lambdas and functors can be inlined.
+    //
+    // The result is the sequence of vertex numbers along the path,
+    // beginning with startVertex and ending with goalVertex, or an empty
+    // std::vector if the goal is unreachable.  If either vertex does not
+    // exist, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc, typename HeuristicFunc>
+    std::vector<int> aStar(
+        int startVertex, int goalVertex,
+        EdgeWeightFunc edgeWeightFunc, HeuristicFunc heuristicFunc) const;
+
+    // breadthFirstSearch() visits every vertex reachable from the start
+    // vertex in breadth-first order.  The result is returned as a
+    // std::map<int, BFSInfo> containing only the reached vertices, where
+    // each BFSInfo holds the vertex's level (the fewest edges on a path
+    // from the start vertex) and its parent in the breadth-first tree.
+    // The start vertex has level 0 and is its own parent.  If the start
+    // vertex does not exist, a DigraphException is thrown instead.
+    std::map<int, BFSInfo> breadthFirstSearch(int startVertex) const;
+
+    // topologicalOrder() returns the vertex numbers of every vertex in an
+    // order in which each edge points from an earlier vertex to a later
+    // one, found with Kahn's algorithm (ties go to the smaller vertex
+    // number).  If the Digraph has a cycle, so that no such order exists,
+    // a DigraphException is thrown instead.
+    std::vector<int> topologicalOrder() const;
+
+    // findDAGShortestPaths() is like findShortestPaths(), except that it
+    // requires the Digraph to be acyclic and then relaxes each edge once
+    // in topological order, which takes linear time and also works with
+    // negative edge weights.  If the start vertex does not exist or the
+    // Digraph has a cycle, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findDAGShortestPaths(int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // findDAGLongestPaths() is like findDAGShortestPaths(), except that
+    // each vertex's predecessor is chosen to make the path from the start
+    // vertex as long (heavy) as possible instead.
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findDAGLongestPaths(int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // criticalPath() returns the heaviest path anywhere in an acyclic
+    // Digraph, as the sequence of vertex numbers along it.  With edges
+    // weighted by task durations, its weight is the least time in which
+    // all of the tasks can be finished.  An empty Digraph has an empty
+    // critical path.  If the Digraph has a cycle, a DigraphException is
+    // thrown instead.
+    template <typename EdgeWeightFunc>
+    std::vector<int> criticalPath(EdgeWeightFunc edgeWeightFunc) const;
+
 
 private:
+    // a DigraphBuilder fills in the map directly when loading in bulk
+    friend class DigraphBuilder<VertexInfo, EdgeInfo>;
+
+    // a DynamicShortestPaths reads incoming edges' EdgeInfo straight
+    // through the in-edge index
+    friend class DynamicShortestPaths<VertexInfo, EdgeInfo>;
 
     std::map<int,DigraphVertex<VertexInfo, EdgeInfo>> container;
 
+    bool indexInEdges = false;
+    bool indexOutEdges = true;
+
+    typedef typename std::list<DigraphEdge<EdgeInfo>>::iterator EdgePosition;
+    typedef std::unordered_map<int, EdgePosition> EdgeIndex;
+
+    // the optional indexes live beside the vertices rather than in them,
+    // so a Digraph without them pays nothing per vertex: inIndex[v] maps
+    // the "from" vertex number of each edge into v to the edge's position
+    // in that vertex's edge list, and outIndex[v] maps the "to" vertex
+    // number of each edge leaving v to its position in v's own list
+    std::unordered_map<int, EdgeIndex> inIndex;
+    std::unordered_map<int, EdgeIndex> outIndex;
+
+    void rebuildIndexes();
+
+    typename std::list<DigraphEdge<EdgeInfo>>::const_iterator findEdge(
+        int fromVertex, const DigraphVertex<VertexInfo, EdgeInfo>& fromV, int toVertex) const;
+
+    typedef typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::const_iterator VertexPosition;
+
+    std::vector<VertexPosition> topologicalPositions(
+        std::unordered_map<int, int>& denseIndex, const std::string& caller) const;
+
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findDAGPaths(
+        int startVertex, EdgeWeightFunc& edgeWeightFunc, bool longest, const std::string& caller) const;
+
     void DFTr(int vertexIndex,const DigraphVertex<VertexInfo,EdgeInfo>& v, 
                                             std::map<int,bool>& visitRecords) const;
 
@@ -216,23 +638,32 @@ Digraph<VertexInfo, EdgeInfo>::Digraph()
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+Digraph<VertexInfo, EdgeInfo>::Digraph(bool indexInEdges, bool indexOutEdges)
+    : indexInEdges{indexInEdges}, indexOutEdges{indexOutEdges}
+{
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(const Digraph& d)
+    : container{d.container}, indexInEdges{d.indexInEdges}, indexOutEdges{d.indexOutEdges}
 {
-    for(auto it = d.container.begin(); it!=d.container.end(); it++)
-    {
-        int vertexIndex = it->first;
-        addVertex(vertexIndex,it->second.vinfo);
-        for(auto it_list = it->second.edges.begin(); it_list!=it->second.edges.end();it_list++)
-            addEdge(vertexIndex, it_list->toVertex, it_list->einfo);
-    }
+    // the indexes point into d's lists, so they are rebuilt rather than
+    // copied
+    if(indexInEdges || indexOutEdges)
+        rebuildIndexes();
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(Digraph&& d) noexcept
+    : container{std::move(d.container)}, indexInEdges{d.indexInEdges}, indexOutEdges{d.indexOutEdges},
+      inIndex{std::move(d.inIndex)}, outIndex{std::move(d.outIndex)}
 {
-    container = d.container;
+    d.container.clear();
+    d.inIndex.clear();
+    d.outIndex.clear();
 }
 
 template <typename VertexInfo, typename EdgeInfo>
@@ -244,15 +675,11 @@ Digraph<VertexInfo, EdgeInfo>::~Digraph() noexcept
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Digraph& d)
 {
-    container.clear();
-    for(auto it = d.container.begin(); it!=d.container.end(); it++)
+    if(this != &d)
     {
-        int vertexIndex = it->first;
-        addVertex(vertexIndex,it->second.vinfo);
-        for(auto it_list = it->second.edges.begin(); it_list!=it->second.edges.end();it_list++)
-            addEdge(vertexIndex, it_list->toVertex, it_list->einfo);
+        Digraph copy{d};
+        swap(copy);
     }
-    
     return *this;
 }
 
@@ -260,11 +687,84 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Di
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(Digraph&& d) noexcept
 {
-    container = d.container;
+    if(this != &d)
+    {
+        container.clear();
+        inIndex.clear();
+        outIndex.clear();
+        swap(d);
+    }
     return *this;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::swap(Digraph& d) noexcept
+{
+    // std::map and std::list keep their nodes in place when swapped, so
+    // the positions stored in the indexes stay valid
+    container.swap(d.container);
+    std::swap(indexInEdges, d.indexInEdges);
+    std::swap(indexOutEdges, d.indexOutEdges);
+    inIndex.swap(d.inIndex);
+    outIndex.swap(d.outIndex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void swap(Digraph<VertexInfo, EdgeInfo>& a, Digraph<VertexInfo, EdgeInfo>& b) noexcept
+{
+    a.swap(b);
+}
+
+
+// rebuildIndexes() recomputes the incoming and outgoing edge indexes
+// from the edge lists, which is needed whenever the lists themselves were
+// copied wholesale (and copied positions would refer to the lists they
+// were copied from).
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::rebuildIndexes()
+{
+    inIndex.clear();
+    outIndex.clear();
+
+    for(auto it = container.begin(); it != container.end(); it++)
+    {
+        std::list<DigraphEdge<EdgeInfo>>& temp = it->second.edges;
+        for(auto it_list = temp.begin(); it_list != temp.end(); it_list++)
+        {
+            if(indexInEdges)
+                inIndex[it_list->toVertex][it->first] = it_list;
+            if(indexOutEdges)
+                outIndex[it->first][it_list->toVertex] = it_list;
+        }
+    }
+}
+
+
+// findEdge() returns the position of the edge to the given "to" vertex
+// within the edge list of fromV (the vertex numbered fromVertex), or the
+// end of that list if there is no such edge.
+template <typename VertexInfo, typename EdgeInfo>
+typename std::list<DigraphEdge<EdgeInfo>>::const_iterator Digraph<VertexInfo, EdgeInfo>::findEdge(
+    int fromVertex, const DigraphVertex<VertexInfo, EdgeInfo>& fromV, int toVertex) const
+{
+    if(indexOutEdges)
+    {
+        auto it_index = outIndex.find(fromVertex);
+        if(it_index == outIndex.end())
+            return fromV.edges.end();
+        auto it = it_index->second.find(toVertex);
+        return it == it_index->second.end() ? fromV.edges.end() : it->second;
+    }
+
+    for(auto it_list = fromV.edges.begin(); it_list != fromV.edges.end(); it_list++)
+        if(it_list->toVertex == toVertex)
+            return it_list;
+    return fromV.edges.end();
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 std::vector<int> Digraph<VertexInfo, EdgeInfo>::vertices() const
 {
@@ -304,7 +804,33 @@ std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex
 
 
 template <typename VertexInfo, typename EdgeInfo>
-VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
+typename Digraph<VertexInfo, EdgeInfo>::VertexView Digraph<VertexInfo, EdgeInfo>::vertexView() const
+{
+    using Iterator = typename VertexView::iterator_type;
+    return VertexView{Iterator{container.begin()}, Iterator{container.end()}};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+typename Digraph<VertexInfo, EdgeInfo>::EdgeView Digraph<VertexInfo, EdgeInfo>::edgeView() const
+{
+    using Iterator = typename EdgeView::iterator_type;
+    return EdgeView{Iterator{container.begin(), container.end()}, Iterator{container.end(), container.end()}};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+typename Digraph<VertexInfo, EdgeInfo>::OutEdgeView Digraph<VertexInfo, EdgeInfo>::edgeView(int vertex) const
+{
+    auto it = container.find(vertex);
+    if(it == container.end())
+        throw DigraphException{std::string("When edgeView, can't find vertex!")};
+    return OutEdgeView{it->second.edges.begin(), it->second.edges.end()};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo& Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
 {
     auto it = container.find(vertex);
     if(it == container.end())
@@ -315,16 +841,16 @@ VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
 
 
 template <typename VertexInfo, typename EdgeInfo>
-EdgeInfo Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
+const EdgeInfo& Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
 {
     auto it = container.find(fromVertex);
     if(it==container.end())
         throw DigraphException{std::string("When edgeInfo, can't find fromVertex")};
     else
     {
-        for(auto it_list = it->second.edges.begin(); it_list!= it->second.edges.end(); it_list++)
-            if(it_list->toVertex == toVertex)
-                return it_list->einfo;
+        auto it_list = findEdge(fromVertex, it->second, toVertex);
+        if(it_list != it->second.edges.end())
+            return it_list->einfo;
         throw DigraphException{std::string("WHen edgeInfo, can't find toVertex")};
     }
 }
@@ -333,7 +859,7 @@ EdgeInfo Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) c
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinfo)
 {
-    container.insert( std::pair<int,DigraphVertex<VertexInfo,EdgeInfo>>(vertex,DigraphVertex<VertexInfo,EdgeInfo>{vinfo}));
+    container.insert( std::pair<int,DigraphVertex<VertexInfo,EdgeInfo>>(vertex,DigraphVertex<VertexInfo,EdgeInfo>{vinfo, {}}));
     
 }
 
@@ -352,8 +878,19 @@ void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const
         it_2 = container.find(toVertex);
         if(it_2 == container.end())
             throw DigraphException{std::string("When add, can't find endVertex!")};
+        else if(indexInEdges && !indexOutEdges
+                ? inIndex[toVertex].count(fromVertex) != 0
+                : findEdge(fromVertex, it->second, toVertex) != it->second.edges.end())
+            throw DigraphException{std::string("When add, edge already exists!")};
         else
+        {
             it->second.edges.push_back(DigraphEdge<EdgeInfo>{fromVertex,toVertex,einfo});
+            auto it_new = std::prev(it->second.edges.end());
+            if(indexInEdges)
+                inIndex[toVertex][fromVertex] = it_new;
+            if(indexOutEdges)
+                outIndex[fromVertex][toVertex] = it_new;
+        }
     }
 }
 
@@ -364,15 +901,60 @@ void Digraph<VertexInfo, EdgeInfo>::removeVertex(int vertex)
     auto it = container.find(vertex);
     if(it == container.end())
         throw DigraphException{std::string("When removeVertex, vertex not found!")};
-    else
+
+    if(indexInEdges)
+    {
+        // only the vertex's own neighbors need to be touched
+        auto it_index = inIndex.find(vertex);
+        if(it_index != inIndex.end())
+        {
+            for(auto it_in = it_index->second.begin(); it_in != it_index->second.end(); it_in++)
+            {
+                if(it_in->first != vertex)
+                {
+                    container.at(it_in->first).edges.erase(it_in->second);
+                    if(indexOutEdges)
+                        outIndex[it_in->first].erase(vertex);
+                }
+            }
+            inIndex.erase(it_index);
+        }
+        const std::list<DigraphEdge<EdgeInfo>>& temp = it->second.edges;
+        for(auto it_list = temp.begin(); it_list != temp.end(); it_list++)
+            if(it_list->toVertex != vertex)
+                inIndex[it_list->toVertex].erase(vertex);
+
+        outIndex.erase(vertex);
         container.erase(it);
+        return;
+    }
+
+    container.erase(it);
+    outIndex.erase(vertex);
 
     for(it = container.begin();it!=container.end();++it)
     {
         std::list<DigraphEdge<EdgeInfo>>& temp = it->second.edges;
-        for(auto it_list = temp.begin(); it_list!=temp.end();it_list++)
+        if(indexOutEdges)
+        {
+            auto it_index = outIndex.find(it->first);
+            if(it_index == outIndex.end())
+                continue;
+            auto it_out = it_index->second.find(vertex);
+            if(it_out != it_index->second.end())
+            {
+                temp.erase(it_out->second);
+                it_index->second.erase(it_out);
+            }
+            continue;
+        }
+        for(auto it_list = temp.begin(); it_list!=temp.end();)
+        {
             if(it_list->toVertex==vertex)
-                temp.erase(it_list);
+                it_list = temp.erase(it_list);
+            else
+                it_list++;
+        }
     }
 }
 
@@ -385,17 +967,79 @@ void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
         throw DigraphException{std::string("When removeEdge, fromVertex not found!")};
     else
     {
-        std::list<DigraphEdge<EdgeInfo>>& temp = it->second.edges;
-        for(auto it_list = temp.begin(); it_list!=temp.end();it_list++)
-        {
-            if(it_list->toVertex == toVertex)
-            {
-                temp.erase(it_list);
-                return;
-            }
-        }
-        throw DigraphException{std::string("When removeEdge, toVertex not found!")};
+        auto it_list = findEdge(fromVertex, it->second, toVertex);
+        if(it_list == it->second.edges.end())
+            throw DigraphException{std::string("When removeEdge, toVertex not found!")};
+
+        if(indexInEdges)
+            inIndex[toVertex].erase(fromVertex);
+        if(indexOutEdges)
+            outIndex[fromVertex].erase(toVertex);
+        it->second.edges.erase(it_list);
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::inEdges(int vertex) const
+{
+    auto it = container.find(vertex);
+    if(it == container.end())
+        throw DigraphException{std::string("When inEdges, vertex not found!")};
+
+    std::vector<std::pair<int,int>> edgesToVertex;
+    if(indexInEdges)
+    {
+        auto it_index = inIndex.find(vertex);
+        if(it_index != inIndex.end())
+            for(auto it_in = it_index->second.begin(); it_in != it_index->second.end(); it_in++)
+                edgesToVertex.push_back(std::pair<int,int>{it_in->first, vertex});
+    }
+    else
+    {
+        for(auto it_v = container.begin(); it_v != container.end(); it_v++)
+            for(auto it_list = it_v->second.edges.begin(); it_list != it_v->second.edges.end(); it_list++)
+                if(it_list->toVertex == vertex)
+                    edgesToVertex.push_back(std::pair<int,int>{it_list->fromVertex, vertex});
     }
+
+    return edgesToVertex;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int Digraph<VertexInfo, EdgeInfo>::inDegree(int vertex) const
+{
+    auto it = container.find(vertex);
+    if(it == container.end())
+        throw DigraphException{std::string("When inDegree, vertex not found!")};
+
+    if(indexInEdges)
+    {
+        auto it_index = inIndex.find(vertex);
+        return it_index == inIndex.end() ? 0 : it_index->second.size();
+    }
+
+    int degree = 0;
+    for(auto it_v = container.begin(); it_v != container.end(); it_v++)
+        for(auto it_list = it_v->second.edges.begin(); it_list != it_v->second.edges.end(); it_list++)
+            if(it_list->toVertex == vertex)
+                degree++;
+    return degree;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool Digraph<VertexInfo, EdgeInfo>::hasInEdgeIndex() const noexcept
+{
+    return indexInEdges;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool Digraph<VertexInfo, EdgeInfo>::hasOutEdgeIndex() const noexcept
+{
+    return indexOutEdges;
 }
 
 
@@ -471,16 +1115,18 @@ void Digraph<VertexInfo, EdgeInfo>::DFTr(int vertexIndex,
 struct DijkstraInfo
 {
     bool kFlag;
-    int d;
+    double d;
     int p;
 };
 
+// Compare orders (distance, vertex) pairs so that a std::priority_queue
+// using it pops the smallest distance first.
 class Compare
 {
 public:
-    bool operator() (const std::pair<int,int>& lhs, const std::pair<int,int>& rhs)
+    bool operator() (const std::pair<double,int>& lhs, const std::pair<double,int>& rhs) const
     {
-        return lhs.first < rhs.first;
+        return lhs.first > rhs.first;
     }
 };
 
@@ -496,13 +1142,13 @@ std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
     std::map<int,DijkstraInfo> vData;
     //initialization
     for(auto it=container.begin(); it!=container.end();it++)
-        vData[it->first] = DijkstraInfo{false,std::numeric_limits<int>::max(),it->first};
+        vData[it->first] = DijkstraInfo{false,std::numeric_limits<double>::infinity(),it->first};
     vData[startVertex].d = 0;
     vData[startVertex].p = startVertex;
 
-    std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int>>, Compare> pqueue;
+    std::priority_queue<std::pair<double,int>, std::vector<std::pair<double,int>>, Compare> pqueue;
                                   
-    pqueue.push(std::pair<int,int>{0,startVertex});
+    pqueue.push(std::pair<double,int>{0.0,startVertex});
 
     while(pqueue.size()!=0)
     {
@@ -514,20 +1160,23 @@ std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
         if(vD.kFlag == false)
         {
             vD.kFlag = true;
-            auto edges_list = container.at(vIndex).edges;
+            const std::list<DigraphEdge<EdgeInfo>>& edges_list = container.at(vIndex).edges;
             for(auto it_list = edges_list.begin();it_list!=edges_list.end();it_list++)
             {
                 //std::cout<<"\tedge: "<<it_list->toVertex<<std::endl;
                 DijkstraInfo& wD = vData[it_list->toVertex];
+                double weight = edgeWeightFunc(it_list->einfo);
+                if(weight < 0.0)
+                    throw DigraphException{std::string("When findShortestPaths, negative edge weight!")};
                 //std::cout<<"\t  dw = "<<wD.d<<std::endl;
-                //std::cout<<"\t  rhs = "<< vD.d+edgeWeightFunc(it_list->einfo)<<std::endl;
-                if(wD.d > (vD.d + edgeWeightFunc(it_list->einfo)))
+                //std::cout<<"\t  rhs = "<< vD.d+weight<<std::endl;
+                if(wD.d > (vD.d + weight))
                 {
       
                     //std::cout<<"\t  change"<<std::endl;
-                    wD.d = vD.d + edgeWeightFunc(it_list->einfo);
+                    wD.d = vD.d + weight;
                     wD.p = vIndex;
-                    pqueue.push(std::pair<int,int>{wD.d,it_list->toVertex});
+                    pqueue.push(std::pair<double,int>{wD.d,it_list->toVertex});
                 }
             }
         }
@@ -542,6 +1191,287 @@ std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, BFSInfo> Digraph<VertexInfo, EdgeInfo>::breadthFirstSearch(int startVertex) const
+{
+    if(container.find(startVertex) == container.end())
+        throw DigraphException{std::string("When breadthFirstSearch, startVertex not found!")};
+
+    std::map<int, BFSInfo> visited;
+    visited[startVertex] = BFSInfo{0, startVertex};
+
+    std::queue<int> q;
+    q.push(startVertex);
+    while(!q.empty())
+    {
+        int vIndex = q.front();
+        q.pop();
+        int level = visited[vIndex].level;
+
+        const std::list<DigraphEdge<EdgeInfo>>& edges_list = container.at(vIndex).edges;
+        for(auto it_list = edges_list.begin(); it_list != edges_list.end(); it_list++)
+        {
+            if(visited.insert(std::pair<int,BFSInfo>{it_list->toVertex, BFSInfo{level + 1, vIndex}}).second)
+                q.push(it_list->toVertex);
+        }
+    }
+
+    return visited;
+}
+
+
+// topologicalPositions() gives every vertex a dense index (in increasing
+// order of vertex number) in denseIndex, and returns the vertices in
+// topological order, or throws on behalf of the named caller if there is
+// a cycle.
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<typename Digraph<VertexInfo, EdgeInfo>::VertexPosition>
+Digraph<VertexInfo, EdgeInfo>::topologicalPositions(
+    std::unordered_map<int, int>& denseIndex, const std::string& caller) const
+{
+    int n = container.size();
+    std::vector<VertexPosition> positions;
+    positions.reserve(n);
+    denseIndex.reserve(n);
+    for(auto it = container.begin(); it != container.end(); it++)
+    {
+        denseIndex.emplace(it->first, positions.size());
+        positions.push_back(it);
+    }
+
+    std::vector<int> remaining(n, 0);
+    for(const DigraphEdge<EdgeInfo>& e : edgeView())
+        remaining[denseIndex.at(e.toVertex)]++;
+
+    // a min-heap of ready vertices keeps the order deterministic
+    std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+    for(int i = 0; i < n; i++)
+        if(remaining[i] == 0)
+            ready.push(i);
+
+    std::vector<VertexPosition> order;
+    order.reserve(n);
+    while(!ready.empty())
+    {
+        int i = ready.top();
+        ready.pop();
+        order.push_back(positions[i]);
+        for(const DigraphEdge<EdgeInfo>& e : positions[i]->second.edges)
+        {
+            int j = denseIndex.at(e.toVertex);
+            if(--remaining[j] == 0)
+                ready.push(j);
+        }
+    }
+
+    if(static_cast<int>(order.size()) != n)
+        throw DigraphException{std::string("When ") + caller + ", graph has a cycle!"};
+    return order;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> Digraph<VertexInfo, EdgeInfo>::topologicalOrder() const
+{
+    std::unordered_map<int, int> denseIndex;
+    std::vector<VertexPosition> order = topologicalPositions(denseIndex, "topologicalOrder");
+
+    std::vector<int> ans;
+    ans.reserve(order.size());
+    for(VertexPosition it : order)
+        ans.push_back(it->first);
+    return ans;
+}
+
+
+// findDAGPaths() does the work of findDAGShortestPaths() and (with
+// longest set) findDAGLongestPaths(): once the vertices are in
+// topological order, every path into a vertex has been settled before it
+// is reached, so one relaxation of each edge suffices.
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findDAGPaths(
+    int startVertex, EdgeWeightFunc& edgeWeightFunc, bool longest, const std::string& caller) const
+{
+    if(container.find(startVertex) == container.end())
+        throw DigraphException{std::string("When ") + caller + ", startVertex not found!"};
+
+    std::unordered_map<int, int> denseIndex;
+    std::vector<VertexPosition> order = topologicalPositions(denseIndex, caller);
+
+    // distances are negated for the longest paths, so both are minimized
+    double sign = longest ? -1.0 : 1.0;
+    std::vector<double> d(order.size(), std::numeric_limits<double>::infinity());
+    std::vector<int> p(order.size());
+    int start = denseIndex.at(startVertex);
+    d[start] = 0.0;
+    p[start] = startVertex;
+
+    for(VertexPosition it : order)
+    {
+        int v = denseIndex.at(it->first);
+        if(d[v] == std::numeric_limits<double>::infinity())
+            continue;
+        for(const DigraphEdge<EdgeInfo>& e : it->second.edges)
+        {
+            int w = denseIndex.at(e.toVertex);
+            double dw = d[v] + sign * edgeWeightFunc(e.einfo);
+            if(dw < d[w])
+            {
+                d[w] = dw;
+                p[w] = it->first;
+            }
+        }
+    }
+
+    std::map<int, int> ans;
+    for(auto it = container.begin(); it != container.end(); it++)
+    {
+        int v = denseIndex.at(it->first);
+        ans.emplace_hint(ans.end(), it->first,
+                         d[v] == std::numeric_limits<double>::infinity() ? it->first : p[v]);
+    }
+    return ans;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findDAGShortestPaths(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    return findDAGPaths(startVertex, edgeWeightFunc, false, "findDAGShortestPaths");
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findDAGLongestPaths(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    return findDAGPaths(startVertex, edgeWeightFunc, true, "findDAGLongestPaths");
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::vector<int> Digraph<VertexInfo, EdgeInfo>::criticalPath(EdgeWeightFunc edgeWeightFunc) const
+{
+    std::unordered_map<int, int> denseIndex;
+    std::vector<VertexPosition> order = topologicalPositions(denseIndex, "criticalPath");
+    if(order.empty())
+        return std::vector<int>{};
+
+    // every vertex may begin the path, so all of them start at length 0
+    std::vector<double> length(order.size(), 0.0);
+    std::vector<int> p(order.size(), -1);
+    for(VertexPosition it : order)
+    {
+        int v = denseIndex.at(it->first);
+        for(const DigraphEdge<EdgeInfo>& e : it->second.edges)
+        {
+            int w = denseIndex.at(e.toVertex);
+            double lw = length[v] + edgeWeightFunc(e.einfo);
+            if(lw > length[w])
+            {
+                length[w] = lw;
+                p[w] = v;
+            }
+        }
+    }
+
+    int last = std::max_element(length.begin(), length.end()) - length.begin();
+    std::vector<VertexPosition> positions(order.size());
+    for(VertexPosition it : order)
+        positions[denseIndex.at(it->first)] = it;
+
+    std::vector<int> path;
+    for(int v = last; v != -1; v = p[v])
+        path.push_back(positions[v]->first);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+
+// AStarInfo is the per-vertex bookkeeping for aStar().  Only vertices
+// the search actually touches get an entry, which is what lets a good
+// heuristic keep most of the graph out of the search entirely.
+struct AStarInfo
+{
+    bool kFlag;
+    double g;
+    int p;
+};
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename HeuristicFunc>
+std::vector<int> Digraph<VertexInfo, EdgeInfo>::aStar(
+    int startVertex, int goalVertex,
+    EdgeWeightFunc edgeWeightFunc, HeuristicFunc heuristicFunc) const
+{
+    auto it_start = container.find(startVertex);
+    if(it_start == container.end())
+        throw DigraphException{std::string("When aStar, startVertex not found!")};
+    auto it_goal = container.find(goalVertex);
+    if(it_goal == container.end())
+        throw DigraphException{std::string("When aStar, goalVertex not found!")};
+
+    const VertexInfo& goalInfo = it_goal->second.vinfo;
+
+    std::map<int,AStarInfo> vData;
+    vData[startVertex] = AStarInfo{false, 0.0, startVertex};
+
+    // the queue is keyed on f = g + h, the estimated total path length
+    std::priority_queue<std::pair<double,int>, std::vector<std::pair<double,int>>, Compare> pqueue;
+    pqueue.push(std::pair<double,int>{heuristicFunc(it_start->second.vinfo, goalInfo), startVertex});
+
+    while(pqueue.size()!=0)
+    {
+        int vIndex = pqueue.top().second;
+        pqueue.pop();
+
+        AStarInfo& vD = vData[vIndex];
+        if(vD.kFlag)
+            continue;
+        vD.kFlag = true;
+
+        if(vIndex == goalVertex)
+            break;
+
+        const std::list<DigraphEdge<EdgeInfo>>& edges_list = container.at(vIndex).edges;
+        for(auto it_list = edges_list.begin(); it_list!=edges_list.end(); it_list++)
+        {
+            double g = vD.g + edgeWeightFunc(it_list->einfo);
+            auto it_w = vData.find(it_list->toVertex);
+            if(it_w == vData.end())
+                it_w = vData.insert(std::pair<int,AStarInfo>{it_list->toVertex,
+                    AStarInfo{false, std::numeric_limits<double>::infinity(), it_list->toVertex}}).first;
+
+            AStarInfo& wD = it_w->second;
+            if(!wD.kFlag && g < wD.g)
+            {
+                wD.g = g;
+                wD.p = vIndex;
+                double h = heuristicFunc(container.at(it_list->toVertex).vinfo, goalInfo);
+                pqueue.push(std::pair<double,int>{g + h, it_list->toVertex});
+            }
+        }
+    }
+
+    std::vector<int> path;
+    auto it_g = vData.find(goalVertex);
+    if(it_g == vData.end() || !it_g->second.kFlag)
+        return path;
+
+    for(int v = goalVertex; v != startVertex; v = vData[v].p)
+        path.push_back(v);
+    path.push_back(startVertex);
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
+
+
 
 #endif // DIGRAPH_HPP
 
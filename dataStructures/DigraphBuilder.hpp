@@ -0,0 +1,326 @@
+// DigraphBuilder.hpp
+//
+//
+// A DigraphBuilder collects vertices and edges in flat arrays and then
+// turns them into a Digraph (or a CSRGraph snapshot) all at once.
+//
+// Building a large Digraph one addEdge() call at a time costs two map
+// lookups and a duplicate check per edge.  A DigraphBuilder instead sorts
+// the edges by "from" and "to" vertex number in parallel, validates them
+// in one sweep over the sorted array, and fills in each vertex's edge
+// list in order, appending every vertex to the Digraph's map with a hint
+// so that no lookups are needed at all.
+//
+// The rules are the same as for the Digraph member functions: vertex
+// numbers must be unique, every edge must connect two vertices that were
+// added, and the same edge may not be added twice.  The difference is
+// that violations are only detected (and a DigraphException thrown) when
+// build() or buildSnapshot() is called.
+//
+
+#ifndef DIGRAPHBUILDER_HPP
+#define DIGRAPHBUILDER_HPP
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphBuilder
+{
+public:
+    // Initializes an empty DigraphBuilder that will use the given number
+    // of threads (zero meaning one per hardware thread) when sorting.
+    explicit DigraphBuilder(unsigned int threads = 0);
+
+    // reserve() preallocates room for the given numbers of vertices and
+    // edges, which avoids repeated reallocation when the sizes are known.
+    void reserve(std::size_t vertices, std::size_t edges);
+
+    // addVertex() records a vertex with the given vertex number and
+    // VertexInfo object.
+    void addVertex(int vertex, const VertexInfo& vinfo);
+
+    // addEdge() records an edge pointing from the given "from" vertex
+    // number to the given "to" vertex number, with the given EdgeInfo.
+    void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
+    // vertexCount() and edgeCount() return how many vertices and edges
+    // have been recorded so far.
+    std::size_t vertexCount() const noexcept;
+    std::size_t edgeCount() const noexcept;
+
+    // removeDuplicateEdges() drops every edge that repeats the "from" and
+    // "to" vertex numbers of an edge recorded before it, which is useful
+    // for input (such as many public datasets) that lists some edges more
+    // than once.
+    void removeDuplicateEdges();
+
+    // build() produces a Digraph containing everything recorded so far,
+    // keeping the given indexes (see the Digraph constructor), and leaves
+    // the builder empty.  Each vertex's edge list is ordered
+    // by "to" vertex number.  If the recorded vertices and edges break
+    // any of the rules above, a DigraphException is thrown instead.
+    Digraph<VertexInfo, EdgeInfo> build(bool indexInEdges = false, bool indexOutEdges = true);
+
+    // buildSnapshot() produces a CSRGraph of everything recorded so far,
+    // without edge weights, without going through a Digraph at all.  The
+    // builder keeps its contents.  If the recorded vertices and edges
+    // break any of the rules above, a DigraphException is thrown instead.
+    CSRGraph buildSnapshot();
+
+    // This overload of buildSnapshot() also stores, for each edge, the
+    // weight determined by edgeWeightFunc.
+    template <typename EdgeWeightFunc>
+    CSRGraph buildSnapshot(EdgeWeightFunc edgeWeightFunc);
+
+private:
+    // An EdgeKey is what actually gets sorted: the two vertex numbers and
+    // the position of the edge's EdgeInfo in edgeInfos, so that large
+    // EdgeInfo objects never move during the sort.
+    struct EdgeKey
+    {
+        int fromVertex;
+        int toVertex;
+        std::size_t index;
+    };
+
+    void sortEdges();
+    void prepare();
+
+    template <typename EdgeWeightFunc>
+    CSRGraph snapshot(EdgeWeightFunc* edgeWeightFunc);
+
+private:
+    unsigned int threads;
+    std::vector<std::pair<int, VertexInfo>> vertexList;
+    std::vector<EdgeKey> edgeKeys;
+    std::vector<EdgeInfo> edgeInfos;
+    bool prepared = false;
+};
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphBuilder<VertexInfo, EdgeInfo>::DigraphBuilder(unsigned int threads)
+    : threads{resolveThreadCount(threads)}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::reserve(std::size_t vertices, std::size_t edges)
+{
+    vertexList.reserve(vertices);
+    edgeKeys.reserve(edges);
+    edgeInfos.reserve(edges);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinfo)
+{
+    vertexList.emplace_back(vertex, vinfo);
+    prepared = false;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    edgeKeys.push_back(EdgeKey{fromVertex, toVertex, edgeInfos.size()});
+    edgeInfos.push_back(einfo);
+    prepared = false;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::size_t DigraphBuilder<VertexInfo, EdgeInfo>::vertexCount() const noexcept
+{
+    return vertexList.size();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::size_t DigraphBuilder<VertexInfo, EdgeInfo>::edgeCount() const noexcept
+{
+    return edgeKeys.size();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::removeDuplicateEdges()
+{
+    sortEdges();
+
+    // equal edges are now neighbors, the earliest recorded one first
+    auto last = std::unique(edgeKeys.begin(), edgeKeys.end(),
+        [](const EdgeKey& a, const EdgeKey& b)
+        {
+            return a.fromVertex == b.fromVertex && a.toVertex == b.toVertex;
+        });
+    edgeKeys.erase(last, edgeKeys.end());
+}
+
+
+// sortEdges() sorts the edges by "from" and then "to" vertex number,
+// breaking ties by the order in which they were recorded.
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::sortEdges()
+{
+    parallelSort(edgeKeys.begin(), edgeKeys.end(),
+        [](const EdgeKey& a, const EdgeKey& b)
+        {
+            if(a.fromVertex != b.fromVertex)
+                return a.fromVertex < b.fromVertex;
+            if(a.toVertex != b.toVertex)
+                return a.toVertex < b.toVertex;
+            return a.index < b.index;
+        }, threads);
+}
+
+
+// prepare() sorts the vertices by vertex number and the edges as in
+// sortEdges(), and checks the rules, which the sorted order turns into
+// comparisons between neighbors and binary searches.
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::prepare()
+{
+    if(prepared)
+        return;
+
+    parallelSort(vertexList.begin(), vertexList.end(),
+        [](const std::pair<int, VertexInfo>& a, const std::pair<int, VertexInfo>& b)
+        {
+            return a.first < b.first;
+        }, threads);
+
+    for(std::size_t i = 1; i < vertexList.size(); i++)
+        if(vertexList[i - 1].first == vertexList[i].first)
+            throw DigraphException{std::string("When DigraphBuilder, duplicate vertex!")};
+
+    sortEdges();
+
+    std::vector<int> numbers(vertexList.size());
+    for(std::size_t i = 0; i < vertexList.size(); i++)
+        numbers[i] = vertexList[i].first;
+
+    std::vector<char> bad(threads, 0);
+    long long chunk = (static_cast<long long>(edgeKeys.size()) + threads - 1) / threads;
+    runThreads(threads, [&](unsigned int t)
+    {
+        long long lo = t * chunk;
+        long long hi = std::min<long long>(edgeKeys.size(), lo + chunk);
+        for(long long i = lo; i < hi; i++)
+        {
+            const EdgeKey& e = edgeKeys[i];
+            if(!std::binary_search(numbers.begin(), numbers.end(), e.fromVertex)
+               || !std::binary_search(numbers.begin(), numbers.end(), e.toVertex))
+                bad[t] = 1;
+            else if(i > 0 && edgeKeys[i - 1].fromVertex == e.fromVertex
+                    && edgeKeys[i - 1].toVertex == e.toVertex)
+                bad[t] = 2;
+        }
+    });
+
+    for(char b : bad)
+    {
+        if(b == 1)
+            throw DigraphException{std::string("When DigraphBuilder, edge vertex not found!")};
+        if(b == 2)
+            throw DigraphException{std::string("When DigraphBuilder, duplicate edge!")};
+    }
+
+    prepared = true;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+Digraph<VertexInfo, EdgeInfo> DigraphBuilder<VertexInfo, EdgeInfo>::build(
+    bool indexInEdges, bool indexOutEdges)
+{
+    prepare();
+
+    Digraph<VertexInfo, EdgeInfo> d{indexInEdges, indexOutEdges};
+    std::size_t k = 0;
+    for(std::pair<int, VertexInfo>& v : vertexList)
+    {
+        auto it = d.container.emplace_hint(d.container.end(), v.first,
+            DigraphVertex<VertexInfo, EdgeInfo>{std::move(v.second), {}});
+        std::list<DigraphEdge<EdgeInfo>>& edges = it->second.edges;
+        for(; k < edgeKeys.size() && edgeKeys[k].fromVertex == v.first; k++)
+            edges.push_back(DigraphEdge<EdgeInfo>{v.first, edgeKeys[k].toVertex,
+                                                  std::move(edgeInfos[edgeKeys[k].index])});
+    }
+
+    if(indexInEdges || indexOutEdges)
+        d.rebuildIndexes();
+
+    vertexList.clear();
+    edgeKeys.clear();
+    edgeInfos.clear();
+    prepared = false;
+
+    return d;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CSRGraph DigraphBuilder<VertexInfo, EdgeInfo>::buildSnapshot()
+{
+    return snapshot(static_cast<double(*)(const EdgeInfo&)>(nullptr));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+CSRGraph DigraphBuilder<VertexInfo, EdgeInfo>::buildSnapshot(EdgeWeightFunc edgeWeightFunc)
+{
+    return snapshot(&edgeWeightFunc);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+CSRGraph DigraphBuilder<VertexInfo, EdgeInfo>::snapshot(EdgeWeightFunc* edgeWeightFunc)
+{
+    prepare();
+
+    int n = vertexList.size();
+    std::vector<int> numbers(n);
+    for(int i = 0; i < n; i++)
+        numbers[i] = vertexList[i].first;
+
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> targets(edgeKeys.size());
+    std::vector<double> weights;
+    if(edgeWeightFunc != nullptr)
+        weights.resize(edgeKeys.size());
+
+    // the edges are already grouped by "from" vertex in vertex order, so
+    // each edge's position in edgeKeys is its position in the snapshot
+    std::size_t k = 0;
+    for(int i = 0; i < n; i++)
+    {
+        while(k < edgeKeys.size() && edgeKeys[k].fromVertex == numbers[i])
+            k++;
+        offsets[i + 1] = k;
+    }
+
+    parallelFor(0, edgeKeys.size(), threads, [&](long long i)
+    {
+        targets[i] = std::lower_bound(numbers.begin(), numbers.end(), edgeKeys[i].toVertex) - numbers.begin();
+        if(edgeWeightFunc != nullptr)
+            weights[i] = (*edgeWeightFunc)(edgeInfos[edgeKeys[i].index]);
+    });
+
+    return CSRGraph{std::move(numbers), std::move(offsets), std::move(targets), std::move(weights)};
+}
+
+
+
+#endif // DIGRAPHBUILDER_HPP
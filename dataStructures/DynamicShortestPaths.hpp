@@ -0,0 +1,383 @@
+// DynamicShortestPaths.hpp
+//
+//
+// A DynamicShortestPaths keeps the result of findShortestPaths() from one
+// start vertex of a Digraph up to date as the Digraph changes, repairing
+// only the part of the shortest path tree that a change affects instead
+// of recomputing everything.
+//
+// The DynamicShortestPaths doesn't see the Digraph change by itself;
+// after each change to the Digraph, the matching notification member
+// function (edgeAdded(), edgeRemoved(), edgeWeightChanged(), and so on)
+// has to be called before the next change is made.
+//
+//   * An edge that is added or becomes lighter can only shorten paths, so
+//     the repair is a Dijkstra search that starts at the edge's "to"
+//     vertex and visits only the vertices whose distance improves.
+//
+//   * An edge of the shortest path tree that is removed or becomes
+//     heavier can lengthen the paths of every vertex below it in the
+//     tree.  Those vertices are collected, given the best distance
+//     offered by an edge from outside that subtree, and settled with a
+//     Dijkstra search restricted to them.
+//
+//   * Any other removal or weight increase changes nothing.
+//
+// The subtree repair looks at the incoming edges of the affected
+// vertices, which takes time proportional to their in-degrees if the
+// Digraph keeps an in-edge index (see the Digraph constructor), and one
+// pass over all edges otherwise.  vertexRemoved() also looks through
+// every vertex's entry to find the removed vertex's children, which
+// takes time proportional to the number of vertices.  As with
+// findShortestPaths(), edge weights must not be negative.
+//
+
+#ifndef DYNAMICSHORTESTPATHS_HPP
+#define DYNAMICSHORTESTPATHS_HPP
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class DynamicShortestPaths
+{
+public:
+    // Computes shortest paths in the given Digraph from the given start
+    // vertex, with edge weights determined by edgeWeightFunc exactly as
+    // in findShortestPaths().  The Digraph is kept by reference, so it
+    // must outlive the DynamicShortestPaths.  If the start vertex does
+    // not exist, a DigraphException is thrown instead.
+    DynamicShortestPaths(
+        const Digraph<VertexInfo, EdgeInfo>& d, int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc);
+
+    // startVertex() returns the vertex number of the start vertex.
+    int startVertex() const noexcept;
+
+    // distance() returns the length of a shortest path from the start
+    // vertex to the given vertex, or infinity if there is none.  If the
+    // vertex does not exist, a DigraphException is thrown instead.
+    double distance(int vertex) const;
+
+    // predecessor() returns the vertex before the given one on a shortest
+    // path from the start vertex, or the vertex itself for the start
+    // vertex and unreached vertices.  If the vertex does not exist, a
+    // DigraphException is thrown instead.
+    int predecessor(int vertex) const;
+
+    // predecessors() returns the predecessor of every vertex, in the same
+    // form as Digraph::findShortestPaths().
+    std::map<int, int> predecessors() const;
+
+    // edgeAdded() is called after the given edge was added to the Digraph.
+    void edgeAdded(int fromVertex, int toVertex);
+
+    // edgeRemoved() is called after the given edge was removed from the
+    // Digraph.
+    void edgeRemoved(int fromVertex, int toVertex);
+
+    // edgeWeightChanged() is called after the EdgeInfo of the given edge
+    // changed in a way that may have changed its weight.
+    void edgeWeightChanged(int fromVertex, int toVertex);
+
+    // vertexAdded() is called after the given vertex was added to the
+    // Digraph.
+    void vertexAdded(int vertex);
+
+    // vertexRemoved() is called after the given vertex (and so all of its
+    // edges) was removed from the Digraph.  If it is the start vertex, a
+    // DigraphException is thrown instead.
+    void vertexRemoved(int vertex);
+
+    // recompute() throws away what is known and computes all shortest
+    // paths again from scratch, which is useful after changes too large
+    // or too many to repair one at a time.
+    void recompute();
+
+private:
+    struct Entry
+    {
+        double distance;
+        int predecessor;
+    };
+
+    typedef std::pair<double, int> QueueItem;
+    typedef std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> Queue;
+
+    Entry& entry(int vertex, const std::string& caller);
+    void relax(int fromVertex, int toVertex, double weight);
+    void propagate(Queue& pqueue);
+    void repairSubtrees(const std::vector<int>& roots);
+
+private:
+    const Digraph<VertexInfo, EdgeInfo>& d;
+    int start;
+    std::function<double(const EdgeInfo&)> edgeWeightFunc;
+    std::unordered_map<int, Entry> entries;
+};
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DynamicShortestPaths<VertexInfo, EdgeInfo>::DynamicShortestPaths(
+    const Digraph<VertexInfo, EdgeInfo>& d, int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc)
+    : d{d}, start{startVertex}, edgeWeightFunc{std::move(edgeWeightFunc)}
+{
+    recompute();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int DynamicShortestPaths<VertexInfo, EdgeInfo>::startVertex() const noexcept
+{
+    return start;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+double DynamicShortestPaths<VertexInfo, EdgeInfo>::distance(int vertex) const
+{
+    auto it = entries.find(vertex);
+    if(it == entries.end())
+        throw DigraphException{std::string("When DynamicShortestPaths distance, vertex not found!")};
+    return it->second.distance;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int DynamicShortestPaths<VertexInfo, EdgeInfo>::predecessor(int vertex) const
+{
+    auto it = entries.find(vertex);
+    if(it == entries.end())
+        throw DigraphException{std::string("When DynamicShortestPaths predecessor, vertex not found!")};
+    return it->second.predecessor;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> DynamicShortestPaths<VertexInfo, EdgeInfo>::predecessors() const
+{
+    std::map<int, int> ans;
+    for(const std::pair<const int, Entry>& e : entries)
+        ans.emplace(e.first, e.second.predecessor);
+    return ans;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::recompute()
+{
+    entries.clear();
+    entries.reserve(d.vertexCount());
+    for(int vertex : d.vertexView())
+        entries.emplace(vertex, Entry{std::numeric_limits<double>::infinity(), vertex});
+
+    auto it = entries.find(start);
+    if(it == entries.end())
+        throw DigraphException{std::string("When DynamicShortestPaths, startVertex not found!")};
+    it->second.distance = 0.0;
+
+    Queue pqueue;
+    pqueue.push(QueueItem{0.0, start});
+    propagate(pqueue);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::edgeAdded(int fromVertex, int toVertex)
+{
+    entry(fromVertex, "edgeAdded");
+    entry(toVertex, "edgeAdded");
+    relax(fromVertex, toVertex, edgeWeightFunc(d.edgeInfo(fromVertex, toVertex)));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::edgeRemoved(int fromVertex, int toVertex)
+{
+    entry(fromVertex, "edgeRemoved");
+    Entry& to = entry(toVertex, "edgeRemoved");
+
+    // only a tree edge carries shortest paths
+    if(to.predecessor == fromVertex && toVertex != start && toVertex != fromVertex)
+        repairSubtrees(std::vector<int>{toVertex});
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::edgeWeightChanged(int fromVertex, int toVertex)
+{
+    Entry& from = entry(fromVertex, "edgeWeightChanged");
+    Entry& to = entry(toVertex, "edgeWeightChanged");
+    double weight = edgeWeightFunc(d.edgeInfo(fromVertex, toVertex));
+
+    if(to.predecessor == fromVertex && toVertex != start && toVertex != fromVertex
+       && from.distance + weight > to.distance)
+        repairSubtrees(std::vector<int>{toVertex});
+    else
+        relax(fromVertex, toVertex, weight);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::vertexAdded(int vertex)
+{
+    entries.emplace(vertex, Entry{std::numeric_limits<double>::infinity(), vertex});
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::vertexRemoved(int vertex)
+{
+    if(vertex == start)
+        throw DigraphException{std::string("When DynamicShortestPaths vertexRemoved, can't remove startVertex!")};
+    entry(vertex, "vertexRemoved");
+    entries.erase(vertex);
+
+    // the vertex's edges are gone, so its children are found by scanning
+    std::vector<int> children;
+    for(const std::pair<const int, Entry>& e : entries)
+        if(e.second.predecessor == vertex)
+            children.push_back(e.first);
+    if(!children.empty())
+        repairSubtrees(children);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+typename DynamicShortestPaths<VertexInfo, EdgeInfo>::Entry&
+DynamicShortestPaths<VertexInfo, EdgeInfo>::entry(int vertex, const std::string& caller)
+{
+    auto it = entries.find(vertex);
+    if(it == entries.end())
+        throw DigraphException{std::string("When DynamicShortestPaths ") + caller + ", vertex not found!"};
+    return it->second;
+}
+
+
+// relax() lets the given edge shorten the path to its "to" vertex and
+// passes any improvement on.
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::relax(int fromVertex, int toVertex, double weight)
+{
+    double candidate = entries.at(fromVertex).distance + weight;
+    Entry& to = entries.at(toVertex);
+    if(candidate < to.distance)
+    {
+        to.distance = candidate;
+        to.predecessor = fromVertex;
+        Queue pqueue;
+        pqueue.push(QueueItem{candidate, toVertex});
+        propagate(pqueue);
+    }
+}
+
+
+// propagate() runs Dijkstra's algorithm from whatever is in the queue,
+// which only ever lowers distances, so it visits exactly the vertices
+// that improve.
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::propagate(Queue& pqueue)
+{
+    while(!pqueue.empty())
+    {
+        QueueItem top = pqueue.top();
+        pqueue.pop();
+        if(top.first > entries.at(top.second).distance)
+            continue;
+
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(top.second))
+        {
+            Entry& to = entries.at(e.toVertex);
+            double candidate = top.first + edgeWeightFunc(e.einfo);
+            if(candidate < to.distance)
+            {
+                to.distance = candidate;
+                to.predecessor = top.second;
+                pqueue.push(QueueItem{candidate, e.toVertex});
+            }
+        }
+    }
+}
+
+
+// repairSubtrees() recomputes the paths of every vertex below the given
+// roots in the shortest path tree, whose own paths may have become
+// longer or disappeared.
+template <typename VertexInfo, typename EdgeInfo>
+void DynamicShortestPaths<VertexInfo, EdgeInfo>::repairSubtrees(const std::vector<int>& roots)
+{
+    std::unordered_set<int> affected{roots.begin(), roots.end()};
+    std::vector<int> stack{roots};
+    std::vector<int> order;
+    while(!stack.empty())
+    {
+        int vertex = stack.back();
+        stack.pop_back();
+        order.push_back(vertex);
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertex))
+        {
+            const Entry& to = entries.at(e.toVertex);
+            if(to.predecessor == vertex && e.toVertex != vertex && affected.insert(e.toVertex).second)
+                stack.push_back(e.toVertex);
+        }
+    }
+
+    for(int vertex : order)
+        entries.at(vertex) = Entry{std::numeric_limits<double>::infinity(), vertex};
+
+    // every affected vertex starts from its best edge into the subtree
+    auto offer = [&](int fromVertex, int toVertex, const EdgeInfo& einfo)
+    {
+        if(affected.count(fromVertex) != 0)
+            return;
+        double candidate = entries.at(fromVertex).distance + edgeWeightFunc(einfo);
+        Entry& to = entries.at(toVertex);
+        if(candidate < to.distance)
+        {
+            to.distance = candidate;
+            to.predecessor = fromVertex;
+        }
+    };
+
+    if(d.hasInEdgeIndex())
+    {
+        // the index holds each edge's position in its "from" vertex's
+        // list, so the EdgeInfo is reached without searching that list
+        for(int vertex : order)
+        {
+            auto it_index = d.inIndex.find(vertex);
+            if(it_index != d.inIndex.end())
+                for(const auto& in : it_index->second)
+                    offer(in.first, vertex, in.second->einfo);
+        }
+    }
+    else
+    {
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView())
+            if(affected.count(e.toVertex) != 0)
+                offer(e.fromVertex, e.toVertex, e.einfo);
+    }
+
+    Queue pqueue;
+    for(int vertex : order)
+    {
+        double distance = entries.at(vertex).distance;
+        if(distance != std::numeric_limits<double>::infinity())
+            pqueue.push(QueueItem{distance, vertex});
+    }
+    propagate(pqueue);
+}
+
+
+
+#endif // DYNAMICSHORTESTPATHS_HPP
@@ -0,0 +1,411 @@
+// EdgeListReader.hpp
+//
+//
+// Readers for three common plain-text graph formats, which record what
+// they read into a DigraphBuilder:
+//
+//   * SNAP edge lists: one "from to" pair (optionally followed by a
+//     weight) per line, with "#" starting a comment line.  The vertices
+//     are exactly the numbers that appear in some edge.
+//
+//   * DIMACS shortest path (".gr") and maximum flow (".max") files: a
+//     "p sp n m" (or "p max n m") problem line, then one "a from to
+//     weight" line per arc, with "c" starting a comment line.  The
+//     vertices are 1 through n.  The "n" lines of maximum flow files,
+//     which name the source and sink, are skipped.
+//
+//   * MatrixMarket coordinate files: a "%%MatrixMarket matrix coordinate"
+//     banner, then a "rows columns entries" line, then one "row column
+//     [value]" line per entry, with "%" starting a comment line.  Each
+//     entry becomes an edge from its row to its column; for symmetric
+//     matrices the mirrored entries are added as well.  The vertices are
+//     1 through the larger of rows and columns.
+//
+// The input is read in large blocks, each block is cut at line breaks
+// into one piece per thread, and the pieces are parsed in parallel with
+// std::from_chars(), so reading is usually limited by the disk rather
+// than by parsing.  Edges are then recorded in the order they appear.
+//
+// Each edge's EdgeInfo is made by calling edgeInfoFunc with the edge's
+// weight (1.0 if the format or the line doesn't give one), and each
+// vertex gets a default-constructed VertexInfo.  Many public datasets
+// list some edges more than once; DigraphBuilder::removeDuplicateEdges()
+// takes care of that before building.
+//
+
+#ifndef EDGELISTREADER_HPP
+#define EDGELISTREADER_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Digraph.hpp"
+#include "DigraphBuilder.hpp"
+#include "Parallel.hpp"
+
+
+// readSNAP() reads a SNAP edge list from the given stream into the given
+// DigraphBuilder, using the given number of threads (zero meaning one per
+// hardware thread).  If a line can't be parsed, or has anything but blanks
+// after its last field, a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readSNAP(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+              EdgeInfoFunc edgeInfoFunc, unsigned int threads = 0);
+
+
+// readDIMACS() reads a DIMACS shortest path file from the given stream
+// into the given DigraphBuilder.  If a line can't be parsed or there is
+// no problem line, a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readDIMACS(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+                EdgeInfoFunc edgeInfoFunc, unsigned int threads = 0);
+
+
+// readMatrixMarket() reads a MatrixMarket coordinate file from the given
+// stream into the given DigraphBuilder.  Complex values contribute their
+// real part, and pattern matrices have weights of 1.0.  If the banner or
+// a line can't be parsed, the file is in array rather than coordinate
+// format, or the number of entries differs from the one on the size line,
+// a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readMatrixMarket(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+                      EdgeInfoFunc edgeInfoFunc, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    // how much of the input is read (and split between threads) at once
+    constexpr std::size_t EdgeListReader__BLOCK_SIZE = std::size_t{1} << 24;
+
+    struct EdgeListReader__Edge
+    {
+        int fromVertex;
+        int toVertex;
+        double weight;
+    };
+
+
+    // What one thread found in its piece of a block: the edges in order,
+    // plus the values of any header line (such as DIMACS's "p" line).
+    struct EdgeListReader__Piece
+    {
+        std::vector<EdgeListReader__Edge> edges;
+        long long headerValue = -1;
+        bool bad = false;
+    };
+
+
+    inline const char* EdgeListReader__skipBlanks(const char* p, const char* end)
+    {
+        while(p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        return p;
+    }
+
+
+    inline bool EdgeListReader__parseInt(const char*& p, const char* end, long long& value)
+    {
+        p = EdgeListReader__skipBlanks(p, end);
+        std::from_chars_result r = std::from_chars(p, end, value);
+        if(r.ec != std::errc{})
+            return false;
+        p = r.ptr;
+        return true;
+    }
+
+
+    inline bool EdgeListReader__parseDouble(const char*& p, const char* end, double& value)
+    {
+        p = EdgeListReader__skipBlanks(p, end);
+        std::from_chars_result r = std::from_chars(p, end, value);
+        if(r.ec != std::errc{})
+            return false;
+        p = r.ptr;
+        return true;
+    }
+
+
+    // EdgeListReader__parseEdge() parses "from to [weight]" from the line
+    // [p, end), leaving the weight alone if there isn't one.  With complex
+    // set, a weight is followed by an imaginary part, which is dropped.
+    // Anything but blanks after the last field makes the line malformed.
+    inline bool EdgeListReader__parseEdge(
+        const char* p, const char* end, EdgeListReader__Edge& e, bool complex = false)
+    {
+        long long from, to;
+        if(!EdgeListReader__parseInt(p, end, from) || !EdgeListReader__parseInt(p, end, to)
+           || from < std::numeric_limits<int>::min() || from > std::numeric_limits<int>::max()
+           || to < std::numeric_limits<int>::min() || to > std::numeric_limits<int>::max())
+            return false;
+        e.fromVertex = static_cast<int>(from);
+        e.toVertex = static_cast<int>(to);
+
+        p = EdgeListReader__skipBlanks(p, end);
+        if(p != end)
+        {
+            double imaginary;
+            if(!EdgeListReader__parseDouble(p, end, e.weight)
+               || (complex && !EdgeListReader__parseDouble(p, end, imaginary)))
+                return false;
+        }
+        return EdgeListReader__skipBlanks(p, end) == end;
+    }
+
+
+    // EdgeListReader__readBlocks() reads the rest of the stream a block
+    // at a time, and has parseLine(first, last, piece) called for every
+    // line, in parallel, with each thread handling a run of whole lines.
+    // Once a block is parsed, consume(piece) is called for each piece in
+    // input order.
+    template <typename ParseLine, typename Consume>
+    void EdgeListReader__readBlocks(std::istream& in, unsigned int threads,
+                                    ParseLine parseLine, Consume consume)
+    {
+        threads = resolveThreadCount(threads);
+        std::vector<EdgeListReader__Piece> pieces(threads);
+        std::string buffer;
+        std::string carry;
+
+        while(true)
+        {
+            buffer.swap(carry);
+            carry.clear();
+            std::size_t kept = buffer.size();
+            buffer.resize(kept + EdgeListReader__BLOCK_SIZE);
+            in.read(&buffer[kept], EdgeListReader__BLOCK_SIZE);
+            buffer.resize(kept + in.gcount());
+            bool last = !in;
+
+            // an unfinished last line waits for the next block
+            if(!last)
+            {
+                std::size_t cut = buffer.rfind('\n');
+                cut = cut == std::string::npos ? 0 : cut + 1;
+                carry.assign(buffer, cut, std::string::npos);
+                buffer.resize(cut);
+            }
+
+            std::vector<std::size_t> bounds(threads + 1, buffer.size());
+            bounds[0] = 0;
+            for(unsigned int t = 1; t < threads; t++)
+            {
+                std::size_t b = std::max(bounds[t - 1], buffer.size() * t / threads);
+                while(b < buffer.size() && b > 0 && buffer[b - 1] != '\n')
+                    b++;
+                bounds[t] = b;
+            }
+
+            runThreads(threads, [&](unsigned int t)
+            {
+                EdgeListReader__Piece& piece = pieces[t];
+                piece.edges.clear();
+                const char* p = buffer.data() + bounds[t];
+                const char* end = buffer.data() + bounds[t + 1];
+                while(p != end && !piece.bad)
+                {
+                    const char* lineEnd = std::find(p, end, '\n');
+                    const char* first = EdgeListReader__skipBlanks(p, lineEnd);
+                    if(first != lineEnd && !parseLine(first, lineEnd, piece))
+                        piece.bad = true;
+                    p = lineEnd == end ? end : lineEnd + 1;
+                }
+            });
+
+            for(EdgeListReader__Piece& piece : pieces)
+                consume(piece);
+
+            if(last)
+                break;
+        }
+    }
+
+
+    // EdgeListReader__addVertexRange() records vertices 1 through n.
+    template <typename VertexInfo, typename EdgeInfo>
+    void EdgeListReader__addVertexRange(DigraphBuilder<VertexInfo, EdgeInfo>& builder, long long n)
+    {
+        builder.reserve(builder.vertexCount() + n, builder.edgeCount());
+        for(long long v = 1; v <= n; v++)
+            builder.addVertex(static_cast<int>(v), VertexInfo{});
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readSNAP(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+              EdgeInfoFunc edgeInfoFunc, unsigned int threads)
+{
+    typedef impl_::EdgeListReader__Edge Edge;
+    typedef impl_::EdgeListReader__Piece Piece;
+
+    std::vector<int> vertices;
+    impl_::EdgeListReader__readBlocks(in, threads,
+        [](const char* first, const char* last, Piece& piece)
+        {
+            if(*first == '#')
+                return true;
+            Edge e{0, 0, 1.0};
+            if(!impl_::EdgeListReader__parseEdge(first, last, e))
+                return false;
+            piece.edges.push_back(e);
+            return true;
+        },
+        [&](const Piece& piece)
+        {
+            if(piece.bad)
+                throw DigraphException{std::string("When readSNAP, malformed line!")};
+            for(const Edge& e : piece.edges)
+            {
+                builder.addEdge(e.fromVertex, e.toVertex, edgeInfoFunc(e.weight));
+                vertices.push_back(e.fromVertex);
+                vertices.push_back(e.toVertex);
+            }
+        });
+
+    parallelSort(vertices.begin(), vertices.end(), [](int a, int b) { return a < b; }, threads);
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    builder.reserve(builder.vertexCount() + vertices.size(), builder.edgeCount());
+    for(int v : vertices)
+        builder.addVertex(v, VertexInfo{});
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readDIMACS(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+                EdgeInfoFunc edgeInfoFunc, unsigned int threads)
+{
+    typedef impl_::EdgeListReader__Edge Edge;
+    typedef impl_::EdgeListReader__Piece Piece;
+
+    long long n = -1;
+    impl_::EdgeListReader__readBlocks(in, threads,
+        [](const char* first, const char* last, Piece& piece)
+        {
+            if(*first == 'c' || *first == 'n')
+                return true;
+            if(*first == 'p')
+            {
+                // "p sp n m"
+                const char* p = impl_::EdgeListReader__skipBlanks(first + 1, last);
+                const char* word = p;
+                while(p != last && *p != ' ' && *p != '\t')
+                    p++;
+                long long vertices, arcs;
+                if(word == p || !impl_::EdgeListReader__parseInt(p, last, vertices)
+                   || !impl_::EdgeListReader__parseInt(p, last, arcs) || vertices < 0
+                   || impl_::EdgeListReader__skipBlanks(p, last) != last)
+                    return false;
+                piece.headerValue = vertices;
+                return true;
+            }
+            Edge e{0, 0, 1.0};
+            if(*first != 'a' || !impl_::EdgeListReader__parseEdge(first + 1, last, e))
+                return false;
+            piece.edges.push_back(e);
+            return true;
+        },
+        [&](Piece& piece)
+        {
+            if(piece.bad)
+                throw DigraphException{std::string("When readDIMACS, malformed line!")};
+            if(piece.headerValue >= 0)
+            {
+                if(n >= 0)
+                    throw DigraphException{std::string("When readDIMACS, more than one problem line!")};
+                n = piece.headerValue;
+                piece.headerValue = -1;
+            }
+            for(const Edge& e : piece.edges)
+                builder.addEdge(e.fromVertex, e.toVertex, edgeInfoFunc(e.weight));
+        });
+
+    if(n < 0)
+        throw DigraphException{std::string("When readDIMACS, no problem line!")};
+    impl_::EdgeListReader__addVertexRange(builder, n);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeInfoFunc>
+void readMatrixMarket(std::istream& in, DigraphBuilder<VertexInfo, EdgeInfo>& builder,
+                      EdgeInfoFunc edgeInfoFunc, unsigned int threads)
+{
+    typedef impl_::EdgeListReader__Edge Edge;
+    typedef impl_::EdgeListReader__Piece Piece;
+
+    // the banner and the size line are read up front, one line at a time
+    std::string line;
+    std::getline(in, line);
+    for(char& c : line)
+        c = std::tolower(static_cast<unsigned char>(c));
+    std::vector<std::string> words;
+    for(std::size_t i = 0; i < line.size(); )
+    {
+        std::size_t j = line.find_first_of(" \t\r", i);
+        if(j == std::string::npos)
+            j = line.size();
+        if(j > i)
+            words.push_back(line.substr(i, j - i));
+        i = j + 1;
+    }
+    if(words.size() != 5 || words[0] != "%%matrixmarket" || words[1] != "matrix")
+        throw DigraphException{std::string("When readMatrixMarket, not a MatrixMarket file!")};
+    if(words[2] != "coordinate")
+        throw DigraphException{std::string("When readMatrixMarket, only coordinate format is supported!")};
+
+    bool pattern = words[3] == "pattern";
+    bool complex = words[3] == "complex";
+    bool mirror = words[4] == "symmetric" || words[4] == "hermitian";
+    bool skew = words[4] == "skew-symmetric";
+
+    long long rows, columns, entries;
+    while(std::getline(in, line) && (line.empty() || line[0] == '%'))
+        ;
+    const char* p = line.data();
+    const char* end = line.data() + line.size();
+    if(!impl_::EdgeListReader__parseInt(p, end, rows) || !impl_::EdgeListReader__parseInt(p, end, columns)
+       || !impl_::EdgeListReader__parseInt(p, end, entries) || rows < 0 || columns < 0 || entries < 0
+       || impl_::EdgeListReader__skipBlanks(p, end) != end)
+        throw DigraphException{std::string("When readMatrixMarket, malformed size line!")};
+
+    builder.reserve(builder.vertexCount(), builder.edgeCount() + (mirror || skew ? 2 : 1) * entries);
+    long long read = 0;
+    impl_::EdgeListReader__readBlocks(in, threads,
+        [pattern, complex](const char* first, const char* last, Piece& piece)
+        {
+            if(*first == '%')
+                return true;
+            Edge e{0, 0, 1.0};
+            if(!impl_::EdgeListReader__parseEdge(first, last, e, complex))
+                return false;
+            if(pattern)
+                e.weight = 1.0;
+            piece.edges.push_back(e);
+            return true;
+        },
+        [&](const Piece& piece)
+        {
+            if(piece.bad)
+                throw DigraphException{std::string("When readMatrixMarket, malformed line!")};
+            read += piece.edges.size();
+            for(const Edge& e : piece.edges)
+            {
+                builder.addEdge(e.fromVertex, e.toVertex, edgeInfoFunc(e.weight));
+                if((mirror || skew) && e.fromVertex != e.toVertex)
+                    builder.addEdge(e.toVertex, e.fromVertex, edgeInfoFunc(skew ? -e.weight : e.weight));
+            }
+        });
+
+    if(read != entries)
+        throw DigraphException{std::string("When readMatrixMarket, number of entries doesn't match the size line!")};
+    impl_::EdgeListReader__addVertexRange(builder, std::max(rows, columns));
+}
+
+
+
+#endif // EDGELISTREADER_HPP
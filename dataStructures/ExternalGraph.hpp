@@ -0,0 +1,316 @@
+// ExternalGraph.hpp
+//
+//
+// Semi-external algorithms for graphs whose edges don't fit in memory:
+// the state of every vertex is kept in RAM (a few bytes each), while the
+// edges stay in a binary edge file on disk and are streamed through in
+// large sequential reads, never held in memory more than a buffer at a
+// time.
+//
+// An edge file is a small header followed by every edge as a pair of
+// ints, "from" and "to", each a vertex index from 0 to n - 1.  An
+// EdgeFileWriter appends edges to one as they are produced (so it can be
+// written without ever building the graph in memory), and
+// writeEdgeFile() writes a Digraph, with vertices given the same dense
+// indices as in a CSRGraph snapshot.  Everything is stored in the byte
+// order of the machine that wrote it.
+//
+//   * externalConnectedComponents() finds the weakly connected
+//     components in a single pass over the edges, with a union-find over
+//     the vertices; the edges of each buffer are linked by several threads
+//     at once, using the lock-free union-find of ConnectedComponents.hpp.
+//
+//   * externalBreadthFirstSearch() makes one pass over the edges per
+//     level of the search, each pass labeling the targets of the edges
+//     leaving the current level, so it reads the file once per level (the
+//     depth of the search, plus one).
+//
+
+#ifndef EXTERNALGRAPH_HPP
+#define EXTERNALGRAPH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BreadthFirstSearch.hpp"
+#include "ConnectedComponents.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// An EdgeFileWriter writes an edge file for a given number of vertices,
+// one edge at a time.
+
+class EdgeFileWriter
+{
+public:
+    // Creates (or replaces) the edge file at the given path, for vertices
+    // 0 to vertexCount - 1.  If the file can't be created, a
+    // DigraphException is thrown instead.
+    EdgeFileWriter(const std::string& path, int vertexCount);
+
+    // An EdgeFileWriter can't be copied; destroying one closes the file,
+    // ignoring any errors (call close() to see them).
+    EdgeFileWriter(const EdgeFileWriter&) = delete;
+    EdgeFileWriter& operator=(const EdgeFileWriter&) = delete;
+    ~EdgeFileWriter() noexcept;
+
+    // addEdge() appends an edge from one vertex index to another.  If
+    // either is out of range, a DigraphException is thrown instead.
+    void addEdge(int fromIndex, int toIndex);
+
+    // close() writes any buffered edges and finishes the file.  If the
+    // file can't be written, a DigraphException is thrown instead.
+    void close();
+
+private:
+    void flush();
+
+private:
+    std::ofstream out;
+    int vertices;
+    std::uint64_t edges = 0;
+    std::vector<int> buffer;
+};
+
+
+// writeEdgeFile() writes the edges of the given Digraph to an edge file
+// at the given path, with the same dense indices as a CSRGraph snapshot.
+// If the file can't be written, a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo>
+void writeEdgeFile(const std::string& path, const Digraph<VertexInfo, EdgeInfo>& d);
+
+
+// externalConnectedComponents() returns, for every vertex index of the
+// edge file at the given path, the smallest index in its weakly connected
+// component (as weaklyConnectedComponents() would), reading
+// bufferBytes at a time and using the given number of threads (zero
+// meaning one per hardware thread).  If the file can't be read or isn't
+// an edge file, a DigraphException is thrown instead.
+std::vector<int> externalConnectedComponents(
+    const std::string& path, std::size_t bufferBytes = 64 << 20, unsigned int threads = 0);
+
+
+// externalBreadthFirstSearch() searches the graph in the edge file at the
+// given path from the vertex with the given index, reading bufferBytes at
+// a time.  The result is indexed by vertex index, with the same levels as
+// breadthFirstSearch() on the same graph; a vertex's parent is the source
+// of the first edge in the file that reaches it from the previous level.
+// If the file can't be read, isn't an edge file, or the start index is
+// out of range, a DigraphException is thrown instead.
+BFSTree externalBreadthFirstSearch(
+    const std::string& path, int startIndex, std::size_t bufferBytes = 64 << 20);
+
+
+
+namespace impl_
+{
+    constexpr std::uint32_t EdgeFile__MAGIC = 0x45524744;      // "DGRE"
+    constexpr std::uint32_t EdgeFile__VERSION = 1;
+
+    struct EdgeFile__Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t vertexCount;
+        std::uint64_t edgeCount;
+    };
+
+
+    // EdgeFile__scan() reads the edge file at the given path, calling
+    // begin(vertexCount) once before any edges and then func(edges, count)
+    // for each buffer's worth, where edges holds count pairs of ints.
+    template <typename BeginFunc, typename Func>
+    void EdgeFile__scan(const std::string& path, std::size_t bufferBytes,
+                        const char* caller, BeginFunc begin, Func func)
+    {
+        std::ifstream in{path, std::ios::binary};
+        if(!in)
+            throw DigraphException{std::string("When ") + caller + ", can't open file!"};
+
+        EdgeFile__Header header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        in.seekg(0, std::ios::end);
+        std::uint64_t length = in.tellg();
+        if(!in || header.magic != EdgeFile__MAGIC || header.version != EdgeFile__VERSION
+           || header.vertexCount > 0x7fffffff
+           || length != sizeof(header) + header.edgeCount * 2 * sizeof(int))
+            throw DigraphException{std::string("When ") + caller + ", not an edge file!"};
+        in.seekg(sizeof(header));
+
+        begin(static_cast<int>(header.vertexCount));
+
+        std::size_t capacity = std::max<std::size_t>(bufferBytes / (2 * sizeof(int)), 1);
+        std::vector<int> buffer(2 * std::min<std::uint64_t>(capacity, header.edgeCount));
+        for(std::uint64_t done = 0; done < header.edgeCount; )
+        {
+            std::size_t count = std::min<std::uint64_t>(capacity, header.edgeCount - done);
+            in.read(reinterpret_cast<char*>(buffer.data()), count * 2 * sizeof(int));
+            if(!in)
+                throw DigraphException{std::string("When ") + caller + ", can't read file!"};
+            for(std::size_t i = 0; i < 2 * count; i++)
+                if(buffer[i] < 0 || static_cast<std::uint64_t>(buffer[i]) >= header.vertexCount)
+                    throw DigraphException{std::string("When ") + caller + ", vertex index out of range!"};
+
+            func(static_cast<const int*>(buffer.data()), count);
+            done += count;
+        }
+    }
+}
+
+
+inline EdgeFileWriter::EdgeFileWriter(const std::string& path, int vertexCount)
+    : out{path, std::ios::binary | std::ios::trunc}, vertices{vertexCount}
+{
+    if(!out)
+        throw DigraphException{std::string("When EdgeFileWriter, can't open file!")};
+
+    // the edge count is filled in by close()
+    impl_::EdgeFile__Header header{impl_::EdgeFile__MAGIC, impl_::EdgeFile__VERSION,
+                                   static_cast<std::uint64_t>(vertexCount), 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.reserve(1 << 20);
+}
+
+
+inline EdgeFileWriter::~EdgeFileWriter() noexcept
+{
+    try
+    {
+        close();
+    }
+    catch(...)
+    {
+    }
+}
+
+
+inline void EdgeFileWriter::addEdge(int fromIndex, int toIndex)
+{
+    if(fromIndex < 0 || fromIndex >= vertices || toIndex < 0 || toIndex >= vertices)
+        throw DigraphException{std::string("When EdgeFileWriter addEdge, vertex index out of range!")};
+
+    buffer.push_back(fromIndex);
+    buffer.push_back(toIndex);
+    edges++;
+    if(buffer.size() == buffer.capacity())
+        flush();
+}
+
+
+inline void EdgeFileWriter::flush()
+{
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(int));
+    buffer.clear();
+}
+
+
+inline void EdgeFileWriter::close()
+{
+    if(!out.is_open())
+        return;
+
+    flush();
+    out.seekp(offsetof(impl_::EdgeFile__Header, edgeCount));
+    out.write(reinterpret_cast<const char*>(&edges), sizeof(edges));
+    out.close();
+    if(!out)
+        throw DigraphException{std::string("When EdgeFileWriter, can't write file!")};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void writeEdgeFile(const std::string& path, const Digraph<VertexInfo, EdgeInfo>& d)
+{
+    std::vector<int> numbers(d.vertexView().begin(), d.vertexView().end());
+    EdgeFileWriter writer{path, static_cast<int>(numbers.size())};
+
+    int index = 0;
+    for(int vertex : numbers)
+    {
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertex))
+            writer.addEdge(index, std::lower_bound(numbers.begin(), numbers.end(), e.toVertex) - numbers.begin());
+        index++;
+    }
+    writer.close();
+}
+
+
+inline std::vector<int> externalConnectedComponents(
+    const std::string& path, std::size_t bufferBytes, unsigned int threads)
+{
+    threads = resolveThreadCount(threads);
+    std::vector<std::atomic<int>> parent;
+
+    impl_::EdgeFile__scan(path, bufferBytes, "externalConnectedComponents",
+        [&](int n)
+        {
+            parent = std::vector<std::atomic<int>>(n);
+            for(int v = 0; v < n; v++)
+                parent[v].store(v, std::memory_order_relaxed);
+        },
+        [&](const int* edges, std::size_t count)
+        {
+            parallelFor(0, count, threads, [&](long long i)
+            {
+                impl_::Components__link(parent, edges[2 * i], edges[2 * i + 1]);
+            });
+        });
+    impl_::Components__compress(parent, threads);
+
+    std::vector<int> component(parent.size());
+    for(std::size_t v = 0; v < parent.size(); v++)
+        component[v] = parent[v].load(std::memory_order_relaxed);
+    return component;
+}
+
+
+inline BFSTree externalBreadthFirstSearch(
+    const std::string& path, int startIndex, std::size_t bufferBytes)
+{
+    BFSTree tree;
+    int current = 0;
+    bool found = true;
+
+    // each pass labels the next level, until one labels nothing
+    while(found)
+    {
+        found = false;
+        impl_::EdgeFile__scan(path, bufferBytes, "externalBreadthFirstSearch",
+            [&](int n)
+            {
+                if(!tree.level.empty())
+                    return;
+                if(startIndex < 0 || startIndex >= n)
+                    throw DigraphException{std::string("When externalBreadthFirstSearch, start index out of range!")};
+                tree.level.assign(n, -1);
+                tree.parent.assign(n, -1);
+                tree.level[startIndex] = 0;
+                tree.parent[startIndex] = startIndex;
+            },
+            [&](const int* edges, std::size_t count)
+            {
+                for(std::size_t i = 0; i < count; i++)
+                {
+                    int from = edges[2 * i];
+                    int to = edges[2 * i + 1];
+                    if(tree.level[from] == current && tree.level[to] == -1)
+                    {
+                        tree.level[to] = current + 1;
+                        tree.parent[to] = from;
+                        found = true;
+                    }
+                }
+            });
+        current++;
+    }
+    return tree;
+}
+
+
+
+#endif // EXTERNALGRAPH_HPP
@@ -0,0 +1,435 @@
+// GraphFile.hpp
+//
+//
+// A binary graph file stores a Digraph in the same layout as a CSRGraph
+// snapshot, followed by the VertexInfo of every vertex and the EdgeInfo
+// of every edge, so that it can be memory-mapped and used directly: a
+// MappedGraph opens such a file without reading or parsing it, and its
+// topology() is a CSRGraph whose arrays point straight into the file.
+// The operating system pages the parts actually touched in on demand,
+// so opening even a very large graph is immediate.
+//
+// Because the VertexInfo and EdgeInfo objects are used in place, both
+// must be trivially copyable, and a file can only be opened by a
+// MappedGraph with the same VertexInfo and EdgeInfo sizes.  Everything
+// is stored in the byte order of the machine that wrote it, and every
+// section starts on a 64-byte boundary.  VertexInfo and EdgeInfo objects
+// are written as raw bytes, so any padding bytes inside them end up in
+// the file too, with whatever they held in memory.
+//
+// Opening a file checks the whole topology, as the CSRGraph constructor
+// does, so that a corrupt file can't send an algorithm out of bounds.
+// That reads every offset and target once; openUnchecked() skips it for
+// files known to be sound.
+//
+// Memory-mapping uses the POSIX mmap() call.
+//
+
+#ifndef GRAPHFILE_HPP
+#define GRAPHFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+
+
+// writeGraphFile() writes the given Digraph to a binary graph file at the
+// given path, replacing anything already there.  Vertices get the same
+// dense indices as in a CSRGraph snapshot, and edges keep the order of
+// each vertex's edge list.  VertexInfo and EdgeInfo are copied byte for
+// byte, padding included.  If the file can't be written, a
+// DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo>
+void writeGraphFile(const std::string& path, const Digraph<VertexInfo, EdgeInfo>& d);
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class MappedGraph
+{
+    static_assert(std::is_trivially_copyable<VertexInfo>::value,
+                  "A MappedGraph's VertexInfo must be trivially copyable");
+    static_assert(std::is_trivially_copyable<EdgeInfo>::value,
+                  "A MappedGraph's EdgeInfo must be trivially copyable");
+
+public:
+    // Memory-maps the binary graph file at the given path and checks that
+    // its offsets are in order, its targets are in range and its vertex
+    // numbers are increasing.  If the file can't be opened or mapped,
+    // isn't a graph file, fails those checks, or was written with
+    // VertexInfo or EdgeInfo of a different size, a DigraphException is
+    // thrown instead.
+    explicit MappedGraph(const std::string& path);
+
+    // openUnchecked() maps the file like the constructor, but only checks
+    // the header and the ends of the offsets array, so it doesn't touch
+    // most of the file.  A corrupt file opened this way makes the
+    // algorithms run on it read and write out of bounds.
+    static MappedGraph openUnchecked(const std::string& path);
+
+    // A MappedGraph can be moved but not copied; the file stays mapped
+    // until the MappedGraph that ends up owning it is destroyed.
+    MappedGraph(const MappedGraph&) = delete;
+    MappedGraph(MappedGraph&& m) noexcept;
+    ~MappedGraph() noexcept;
+
+    MappedGraph& operator=(const MappedGraph&) = delete;
+    MappedGraph& operator=(MappedGraph&& m) noexcept;
+
+    // topology() returns the unweighted CSRGraph stored in the file.  It
+    // (and every copy of it) is only valid while this MappedGraph is.
+    const CSRGraph& topology() const noexcept;
+
+    // vertexCount() and edgeCount() return the number of vertices and
+    // edges in the file.
+    int vertexCount() const noexcept;
+    int edgeCount() const noexcept;
+
+    // vertexInfo() returns the VertexInfo of the vertex with the given
+    // dense index.
+    const VertexInfo& vertexInfo(int index) const;
+
+    // edgeInfo() returns the EdgeInfo of the edge at the given position
+    // in topology().targets().
+    const EdgeInfo& edgeInfo(int edgeIndex) const;
+
+    // weighted() returns a snapshot sharing the mapped topology, with the
+    // weight determined by edgeWeightFunc stored for each edge, ready for
+    // deltaStepping() and the other weighted algorithms.  Like topology(),
+    // it is only valid while this MappedGraph is.
+    template <typename EdgeWeightFunc>
+    CSRGraph weighted(EdgeWeightFunc edgeWeightFunc) const;
+
+private:
+    MappedGraph(const std::string& path, bool check);
+
+    void unmap() noexcept;
+
+private:
+    void* address = nullptr;
+    std::size_t length = 0;
+    CSRGraph graph;
+    const VertexInfo* vinfos = nullptr;
+    const EdgeInfo* einfos = nullptr;
+};
+
+
+
+namespace impl_
+{
+    constexpr std::uint32_t GraphFile__MAGIC = 0x46524744;     // "DGRF"
+    constexpr std::uint32_t GraphFile__VERSION = 1;
+    constexpr std::uint64_t GraphFile__ALIGNMENT = 64;
+
+    struct GraphFile__Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t vertexInfoSize;
+        std::uint32_t edgeInfoSize;
+        std::uint64_t vertexCount;
+        std::uint64_t edgeCount;
+        std::uint64_t numbersOffset;
+        std::uint64_t offsetsOffset;
+        std::uint64_t targetsOffset;
+        std::uint64_t vertexInfosOffset;
+        std::uint64_t edgeInfosOffset;
+        std::uint64_t fileSize;
+    };
+
+
+    inline std::uint64_t GraphFile__align(std::uint64_t position)
+    {
+        return (position + GraphFile__ALIGNMENT - 1) / GraphFile__ALIGNMENT * GraphFile__ALIGNMENT;
+    }
+
+
+    inline void GraphFile__write(std::ofstream& out, std::uint64_t& position,
+                                 std::uint64_t offset, const void* data, std::size_t bytes)
+    {
+        static const char padding[GraphFile__ALIGNMENT] = {};
+        out.write(padding, offset - position);
+        out.write(static_cast<const char*>(data), bytes);
+        position = offset + bytes;
+    }
+
+
+    // GraphFile__fits() returns true if an array of count objects of the
+    // given size and alignment can start at offset in a file of the given
+    // length, written so that a corrupt header can't make it overflow.
+    inline bool GraphFile__fits(std::uint64_t offset, std::uint64_t count, std::size_t size,
+                                std::size_t alignment, std::uint64_t length)
+    {
+        return offset % alignment == 0 && offset <= length && count <= (length - offset) / size;
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void writeGraphFile(const std::string& path, const Digraph<VertexInfo, EdgeInfo>& d)
+{
+    static_assert(std::is_trivially_copyable<VertexInfo>::value,
+                  "A graph file's VertexInfo must be trivially copyable");
+    static_assert(std::is_trivially_copyable<EdgeInfo>::value,
+                  "A graph file's EdgeInfo must be trivially copyable");
+
+    CSRGraph g{d};
+    std::uint64_t n = g.vertexCount();
+    std::uint64_t m = g.edgeCount();
+
+    std::vector<VertexInfo> vinfos;
+    std::vector<EdgeInfo> einfos;
+    vinfos.reserve(n);
+    einfos.reserve(m);
+    for(int vertex : d.vertexView())
+    {
+        vinfos.push_back(d.vertexInfo(vertex));
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertex))
+            einfos.push_back(e.einfo);
+    }
+
+    impl_::GraphFile__Header header{};
+    header.magic = impl_::GraphFile__MAGIC;
+    header.version = impl_::GraphFile__VERSION;
+    header.vertexInfoSize = sizeof(VertexInfo);
+    header.edgeInfoSize = sizeof(EdgeInfo);
+    header.vertexCount = n;
+    header.edgeCount = m;
+    header.numbersOffset = impl_::GraphFile__align(sizeof(header));
+    header.offsetsOffset = impl_::GraphFile__align(header.numbersOffset + n * sizeof(int));
+    header.targetsOffset = impl_::GraphFile__align(header.offsetsOffset + (n + 1) * sizeof(int));
+    header.vertexInfosOffset = impl_::GraphFile__align(header.targetsOffset + m * sizeof(int));
+    header.edgeInfosOffset = impl_::GraphFile__align(header.vertexInfosOffset + n * sizeof(VertexInfo));
+    header.fileSize = header.edgeInfosOffset + m * sizeof(EdgeInfo);
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if(!out)
+        throw DigraphException{std::string("When writeGraphFile, can't open file!")};
+
+    std::uint64_t position = 0;
+    impl_::GraphFile__write(out, position, 0, &header, sizeof(header));
+    impl_::GraphFile__write(out, position, header.numbersOffset,
+                            g.vertexNumbers().data(), n * sizeof(int));
+    impl_::GraphFile__write(out, position, header.offsetsOffset,
+                            g.offsets().data(), (n + 1) * sizeof(int));
+    impl_::GraphFile__write(out, position, header.targetsOffset,
+                            g.targets().data(), m * sizeof(int));
+    impl_::GraphFile__write(out, position, header.vertexInfosOffset,
+                            vinfos.data(), n * sizeof(VertexInfo));
+    impl_::GraphFile__write(out, position, header.edgeInfosOffset,
+                            einfos.data(), m * sizeof(EdgeInfo));
+
+    out.close();
+    if(!out)
+        throw DigraphException{std::string("When writeGraphFile, can't write file!")};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo>::MappedGraph(const std::string& path)
+    : MappedGraph{path, true}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo> MappedGraph<VertexInfo, EdgeInfo>::openUnchecked(const std::string& path)
+{
+    return MappedGraph{path, false};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo>::MappedGraph(const std::string& path, bool check)
+{
+    static_assert(alignof(VertexInfo) <= impl_::GraphFile__ALIGNMENT
+                  && alignof(EdgeInfo) <= impl_::GraphFile__ALIGNMENT,
+                  "A MappedGraph's VertexInfo and EdgeInfo must fit the file's alignment");
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw DigraphException{std::string("When MappedGraph, can't open file!")};
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(impl_::GraphFile__Header))
+    {
+        ::close(fd);
+        throw DigraphException{std::string("When MappedGraph, not a graph file!")};
+    }
+
+    length = st.st_size;
+    address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED)
+    {
+        address = nullptr;
+        throw DigraphException{std::string("When MappedGraph, can't map file!")};
+    }
+
+    const char* base = static_cast<const char*>(address);
+    const impl_::GraphFile__Header& header = *reinterpret_cast<const impl_::GraphFile__Header*>(base);
+
+    const char* problem = nullptr;
+    if(header.magic != impl_::GraphFile__MAGIC)
+        problem = "When MappedGraph, not a graph file!";
+    else if(header.version != impl_::GraphFile__VERSION)
+        problem = "When MappedGraph, unsupported version!";
+    else if(header.vertexInfoSize != sizeof(VertexInfo) || header.edgeInfoSize != sizeof(EdgeInfo))
+        problem = "When MappedGraph, VertexInfo or EdgeInfo size doesn't match!";
+    else if(header.fileSize != length || header.vertexCount >= 0x7fffffff || header.edgeCount > 0x7fffffff)
+        problem = "When MappedGraph, file is truncated or corrupt!";
+    else if(!impl_::GraphFile__fits(header.numbersOffset, header.vertexCount,
+                                    sizeof(int), alignof(int), length)
+            || !impl_::GraphFile__fits(header.offsetsOffset, header.vertexCount + 1,
+                                       sizeof(int), alignof(int), length)
+            || !impl_::GraphFile__fits(header.targetsOffset, header.edgeCount,
+                                       sizeof(int), alignof(int), length)
+            || !impl_::GraphFile__fits(header.vertexInfosOffset, header.vertexCount,
+                                       sizeof(VertexInfo), alignof(VertexInfo), length)
+            || !impl_::GraphFile__fits(header.edgeInfosOffset, header.edgeCount,
+                                       sizeof(EdgeInfo), alignof(EdgeInfo), length))
+        problem = "When MappedGraph, file is truncated or corrupt!";
+
+    if(problem == nullptr)
+    {
+        std::size_t n = header.vertexCount;
+        std::size_t m = header.edgeCount;
+        graph.numbers = CSRArray<int>{reinterpret_cast<const int*>(base + header.numbersOffset), n};
+        graph.firstEdge = CSRArray<int>{reinterpret_cast<const int*>(base + header.offsetsOffset), n + 1};
+        graph.edgeTargets = CSRArray<int>{reinterpret_cast<const int*>(base + header.targetsOffset), m};
+        vinfos = reinterpret_cast<const VertexInfo*>(base + header.vertexInfosOffset);
+        einfos = reinterpret_cast<const EdgeInfo*>(base + header.edgeInfosOffset);
+
+        if(graph.firstEdge[0] != 0 || graph.firstEdge[n] != static_cast<int>(m))
+            problem = "When MappedGraph, file is truncated or corrupt!";
+    }
+
+    // the same checks as CSRGraph's array constructor, one pass over each
+    // array in file order
+    if(problem == nullptr && check)
+    {
+        int n = graph.vertexCount();
+        for(int i = 0; i < n && problem == nullptr; i++)
+            if(graph.firstEdge[i] > graph.firstEdge[i + 1]
+               || (i > 0 && graph.numbers[i - 1] >= graph.numbers[i]))
+                problem = "When MappedGraph, arrays are out of order!";
+        for(int i = 0; i < graph.edgeCount() && problem == nullptr; i++)
+            if(graph.edgeTargets[i] < 0 || graph.edgeTargets[i] >= n)
+                problem = "When MappedGraph, target out of range!";
+    }
+
+    if(problem != nullptr)
+    {
+        unmap();
+        throw DigraphException{std::string(problem)};
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo>::MappedGraph(MappedGraph&& m) noexcept
+    : address{m.address}, length{m.length}, graph{std::move(m.graph)},
+      vinfos{m.vinfos}, einfos{m.einfos}
+{
+    m.address = nullptr;
+    m.length = 0;
+    m.graph = CSRGraph{};
+    m.vinfos = nullptr;
+    m.einfos = nullptr;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo>::~MappedGraph() noexcept
+{
+    unmap();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+MappedGraph<VertexInfo, EdgeInfo>& MappedGraph<VertexInfo, EdgeInfo>::operator=(MappedGraph&& m) noexcept
+{
+    if(this != &m)
+    {
+        unmap();
+        std::swap(address, m.address);
+        std::swap(length, m.length);
+        std::swap(graph, m.graph);
+        std::swap(vinfos, m.vinfos);
+        std::swap(einfos, m.einfos);
+    }
+    return *this;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void MappedGraph<VertexInfo, EdgeInfo>::unmap() noexcept
+{
+    graph = CSRGraph{};
+    vinfos = nullptr;
+    einfos = nullptr;
+    if(address != nullptr)
+        ::munmap(address, length);
+    address = nullptr;
+    length = 0;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const CSRGraph& MappedGraph<VertexInfo, EdgeInfo>::topology() const noexcept
+{
+    return graph;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int MappedGraph<VertexInfo, EdgeInfo>::vertexCount() const noexcept
+{
+    return graph.vertexCount();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int MappedGraph<VertexInfo, EdgeInfo>::edgeCount() const noexcept
+{
+    return graph.edgeCount();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo& MappedGraph<VertexInfo, EdgeInfo>::vertexInfo(int index) const
+{
+    return vinfos[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& MappedGraph<VertexInfo, EdgeInfo>::edgeInfo(int edgeIndex) const
+{
+    return einfos[edgeIndex];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+CSRGraph MappedGraph<VertexInfo, EdgeInfo>::weighted(EdgeWeightFunc edgeWeightFunc) const
+{
+    std::vector<double> weights(graph.edgeCount());
+    for(int i = 0; i < graph.edgeCount(); i++)
+        weights[i] = edgeWeightFunc(einfos[i]);
+    return graph.withWeights(std::move(weights));
+}
+
+
+
+#endif // GRAPHFILE_HPP
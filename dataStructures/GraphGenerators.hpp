@@ -0,0 +1,171 @@
+// GraphGenerators.hpp
+//
+//
+// Synthetic graphs for benchmarks and experiments, generated as lists of
+// edges between vertices 0 to n - 1 (with no edge from a vertex to itself
+// and no edge listed twice, so every list can be fed straight to
+// Digraph::addEdge() or a DigraphBuilder).  The same seed always gives
+// the same graph.
+//
+//   * rmatEdges() follows the R-MAT (recursive matrix) model of
+//     Chakrabarti, Zhan and Faloutsos, the generator behind the Graph500
+//     "Kronecker" graphs: each edge picks one quadrant of the adjacency
+//     matrix after another with fixed probabilities, which gives the
+//     skewed degrees and small diameter of social and web graphs.
+//
+//   * gridEdges() builds a rows-by-columns grid with edges both ways
+//     between neighbors, the usual stand-in for a road network: every
+//     vertex has at most four neighbors and the diameter is large.
+//
+//   * erdosRenyiEdges() picks edges uniformly at random (the G(n, m)
+//     model), so degrees are all close to the average.
+//
+
+#ifndef GRAPHGENERATORS_HPP
+#define GRAPHGENERATORS_HPP
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+// rmatEdges() returns up to edgeCount edges among 2^scale vertices, drawn
+// with quadrant probabilities a, b, c and 1 - a - b - c (the defaults are
+// Graph500's); repeated edges and edges from a vertex to itself are
+// dropped, so slightly fewer than edgeCount may remain.  Vertex numbers
+// are scrambled, so that high-degree vertices aren't all numbered low.
+// If scale is not between 1 and 30 or the probabilities don't make
+// sense, a DigraphException is thrown instead.
+std::vector<std::pair<int, int>> rmatEdges(
+    int scale, long long edgeCount, unsigned int seed = 1,
+    double a = 0.57, double b = 0.19, double c = 0.19);
+
+
+// gridEdges() returns the edges of a grid with the given numbers of rows
+// and columns, where vertex r * columns + c is joined both ways to the
+// vertices above, below and beside it.
+std::vector<std::pair<int, int>> gridEdges(int rows, int columns);
+
+
+// erdosRenyiEdges() returns edgeCount distinct edges chosen uniformly at
+// random among vertexCount vertices.  If there aren't that many possible
+// edges, a DigraphException is thrown instead.
+std::vector<std::pair<int, int>> erdosRenyiEdges(int vertexCount, long long edgeCount, unsigned int seed = 1);
+
+
+
+namespace impl_
+{
+    // GraphGenerators__dedupe() sorts the edges, drops repeats and edges
+    // from a vertex to itself, and then shuffles what is left, so that
+    // the edges don't arrive grouped by vertex.
+    inline void GraphGenerators__dedupe(std::vector<std::pair<int, int>>& edges, std::mt19937_64& rng)
+    {
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [](const std::pair<int, int>& e) { return e.first == e.second; }),
+                    edges.end());
+        std::shuffle(edges.begin(), edges.end(), rng);
+    }
+}
+
+
+inline std::vector<std::pair<int, int>> rmatEdges(
+    int scale, long long edgeCount, unsigned int seed, double a, double b, double c)
+{
+    if(scale < 1 || scale > 30)
+        throw DigraphException{std::string("When rmatEdges, scale out of range!")};
+    if(a < 0.0 || b < 0.0 || c < 0.0 || a + b + c > 1.0)
+        throw DigraphException{std::string("When rmatEdges, probabilities out of range!")};
+
+    int n = 1 << scale;
+    std::mt19937_64 rng{seed};
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+    std::vector<int> scramble(n);
+    for(int v = 0; v < n; v++)
+        scramble[v] = v;
+    std::shuffle(scramble.begin(), scramble.end(), rng);
+
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(edgeCount);
+    for(long long i = 0; i < edgeCount; i++)
+    {
+        // one bit of the source and the target per level of the matrix
+        int from = 0;
+        int to = 0;
+        for(int bit = scale - 1; bit >= 0; bit--)
+        {
+            double r = uniform(rng);
+            if(r >= a + b + c)
+            {
+                from |= 1 << bit;
+                to |= 1 << bit;
+            }
+            else if(r >= a + b)
+                from |= 1 << bit;
+            else if(r >= a)
+                to |= 1 << bit;
+        }
+        edges.emplace_back(scramble[from], scramble[to]);
+    }
+
+    impl_::GraphGenerators__dedupe(edges, rng);
+    return edges;
+}
+
+
+inline std::vector<std::pair<int, int>> gridEdges(int rows, int columns)
+{
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(4LL * rows * columns);
+    for(int r = 0; r < rows; r++)
+    {
+        for(int c = 0; c < columns; c++)
+        {
+            int v = r * columns + c;
+            if(r + 1 < rows)
+            {
+                edges.emplace_back(v, v + columns);
+                edges.emplace_back(v + columns, v);
+            }
+            if(c + 1 < columns)
+            {
+                edges.emplace_back(v, v + 1);
+                edges.emplace_back(v + 1, v);
+            }
+        }
+    }
+    return edges;
+}
+
+
+inline std::vector<std::pair<int, int>> erdosRenyiEdges(int vertexCount, long long edgeCount, unsigned int seed)
+{
+    if(vertexCount < 0 || edgeCount > static_cast<long long>(vertexCount) * (vertexCount - 1))
+        throw DigraphException{std::string("When erdosRenyiEdges, too many edges!")};
+
+    std::mt19937_64 rng{seed};
+    std::uniform_int_distribution<int> pick{0, std::max(vertexCount - 1, 0)};
+
+    // draw more than needed, drop repeats, and top up until there are
+    // enough; repeats are rare unless the graph is nearly complete
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(edgeCount);
+    while(static_cast<long long>(edges.size()) < edgeCount)
+    {
+        while(static_cast<long long>(edges.size()) < edgeCount + edgeCount / 64 + 16)
+            edges.emplace_back(pick(rng), pick(rng));
+        impl_::GraphGenerators__dedupe(edges, rng);
+    }
+    edges.resize(edgeCount);
+    return edges;
+}
+
+
+
+#endif // GRAPHGENERATORS_HPP
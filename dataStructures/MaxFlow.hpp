@@ -0,0 +1,484 @@
+// MaxFlow.hpp
+//
+//
+// Maximum flow and minimum cut in a Digraph whose edges have capacities,
+// by two classic algorithms:
+//
+//   * maxFlowPushRelabel() is Goldberg and Tarjan's push-relabel
+//     algorithm, processing active vertices in FIFO order, with the two
+//     heuristics that make it fast in practice: "global relabeling"
+//     (periodically recomputing every height exactly with a backward
+//     breadth-first search from the sink) and the "gap" heuristic (when
+//     no vertex is left at some height, every vertex above it can no
+//     longer reach the sink and is lifted out of the way at once).
+//
+//   * maxFlowDinic() is Dinic's algorithm: it repeatedly builds the level
+//     graph of shortest residual paths with a breadth-first search and
+//     saturates it with a blocking flow.
+//
+// Both work on a residual network built from the Digraph in which every
+// edge and its reverse are stored next to each other in one contiguous
+// array, grouped by tail vertex.  The capacity of each edge is determined
+// by capacityFunc, which takes an EdgeInfo object just like the
+// edgeWeightFunc of Digraph::findShortestPaths(); it is a template
+// parameter, so lambdas and functors can be inlined.
+//
+
+#ifndef MAXFLOW_HPP
+#define MAXFLOW_HPP
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+// A MaxFlowResult describes a maximum flow from a source to a sink:
+//
+// * value is the total amount of flow.
+// * edgeFlow holds the flow along every edge that carries any, keyed by
+//   the edge's "from" and "to" vertex numbers.
+// * sourceSide holds the vertex numbers of the vertices that can still
+//   be reached from the source in the residual network, which is the
+//   source side of a minimum cut.
+// * cutEdges holds the "from" and "to" vertex numbers of the edges
+//   leaving the source side, whose capacities add up to value, in
+//   increasing order.
+struct MaxFlowResult
+{
+    double value;
+    std::map<std::pair<int, int>, double> edgeFlow;
+    std::vector<int> sourceSide;
+    std::vector<std::pair<int, int>> cutEdges;
+};
+
+
+// maxFlowPushRelabel() computes a maximum flow from the source vertex to
+// the sink vertex with the push-relabel algorithm.  If either vertex
+// does not exist, they are the same vertex, or some capacity is
+// negative, a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, typename CapacityFunc>
+MaxFlowResult maxFlowPushRelabel(
+    const Digraph<VertexInfo, EdgeInfo>& d, int sourceVertex, int sinkVertex, CapacityFunc capacityFunc);
+
+
+// maxFlowDinic() computes the same result as maxFlowPushRelabel() with
+// Dinic's algorithm.
+template <typename VertexInfo, typename EdgeInfo, typename CapacityFunc>
+MaxFlowResult maxFlowDinic(
+    const Digraph<VertexInfo, EdgeInfo>& d, int sourceVertex, int sinkVertex, CapacityFunc capacityFunc);
+
+
+
+namespace impl_
+{
+    // A MaxFlow__Network is the residual network: arc a and its partner
+    // a ^ 1 are an edge and its reverse, and the arcs leaving vertex v
+    // are listed in arcsOf[first[v]] through arcsOf[first[v + 1] - 1].
+    struct MaxFlow__Network
+    {
+        int n;
+        int source;
+        int sink;
+        std::vector<int> numbers;
+        std::vector<int> head;
+        std::vector<double> residual;
+        std::vector<double> capacity;
+        std::vector<int> first;
+        std::vector<int> arcsOf;
+    };
+
+
+    template <typename VertexInfo, typename EdgeInfo, typename CapacityFunc>
+    MaxFlow__Network MaxFlow__build(
+        const Digraph<VertexInfo, EdgeInfo>& d, int sourceVertex, int sinkVertex,
+        CapacityFunc& capacityFunc, const std::string& caller)
+    {
+        MaxFlow__Network net;
+        net.numbers.assign(d.vertexView().begin(), d.vertexView().end());
+        net.n = net.numbers.size();
+
+        auto indexOf = [&](int vertex)
+        {
+            auto it = std::lower_bound(net.numbers.begin(), net.numbers.end(), vertex);
+            if(it == net.numbers.end() || *it != vertex)
+                throw DigraphException{std::string("When ") + caller + ", vertex not found!"};
+            return static_cast<int>(it - net.numbers.begin());
+        };
+
+        net.source = indexOf(sourceVertex);
+        net.sink = indexOf(sinkVertex);
+        if(net.source == net.sink)
+            throw DigraphException{std::string("When ") + caller + ", source and sink are the same!"};
+
+        int m = d.edgeCount();
+        net.head.resize(2 * m);
+        net.residual.resize(2 * m);
+        net.capacity.resize(2 * m);
+        net.first.assign(net.n + 1, 0);
+
+        int a = 0;
+        std::vector<int> tail(2 * m);
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView())
+        {
+            double c = capacityFunc(e.einfo);
+            if(c < 0.0)
+                throw DigraphException{std::string("When ") + caller + ", negative capacity!"};
+            int u = indexOf(e.fromVertex);
+            int v = indexOf(e.toVertex);
+            tail[a] = u;
+            net.head[a] = v;
+            net.residual[a] = net.capacity[a] = c;
+            tail[a + 1] = v;
+            net.head[a + 1] = u;
+            net.residual[a + 1] = net.capacity[a + 1] = 0.0;
+            net.first[u + 1]++;
+            net.first[v + 1]++;
+            a += 2;
+        }
+
+        for(int v = 0; v < net.n; v++)
+            net.first[v + 1] += net.first[v];
+        net.arcsOf.resize(2 * m);
+        std::vector<int> pos(net.first.begin(), net.first.end() - 1);
+        for(int arc = 0; arc < 2 * m; arc++)
+            net.arcsOf[pos[tail[arc]]++] = arc;
+
+        return net;
+    }
+
+
+    // MaxFlow__finish() reads the flow and the minimum cut off the final
+    // residual network.
+    inline MaxFlowResult MaxFlow__finish(const MaxFlow__Network& net)
+    {
+        MaxFlowResult result;
+        result.value = 0.0;
+
+        std::vector<char> reached(net.n, false);
+        std::vector<int> queue{net.source};
+        reached[net.source] = true;
+        for(std::size_t q = 0; q < queue.size(); q++)
+        {
+            int v = queue[q];
+            for(int i = net.first[v]; i < net.first[v + 1]; i++)
+            {
+                int a = net.arcsOf[i];
+                if(net.residual[a] > 0.0 && !reached[net.head[a]])
+                {
+                    reached[net.head[a]] = true;
+                    queue.push_back(net.head[a]);
+                }
+            }
+        }
+
+        for(int a = 0; a < static_cast<int>(net.head.size()); a += 2)
+        {
+            int u = net.head[a + 1];
+            int v = net.head[a];
+            double flow = net.capacity[a] - net.residual[a];
+            if(flow > 0.0)
+            {
+                result.edgeFlow[std::pair<int, int>{net.numbers[u], net.numbers[v]}] += flow;
+                if(u == net.source)
+                    result.value += flow;
+                if(v == net.source)
+                    result.value -= flow;
+            }
+            if(reached[u] && !reached[v])
+                result.cutEdges.push_back(std::pair<int, int>{net.numbers[u], net.numbers[v]});
+        }
+
+        // arcs between the same two vertices share one entry in edgeFlow
+        // and cutEdges
+        std::sort(result.cutEdges.begin(), result.cutEdges.end());
+        result.cutEdges.erase(std::unique(result.cutEdges.begin(), result.cutEdges.end()),
+                              result.cutEdges.end());
+
+        for(int v = 0; v < net.n; v++)
+            if(reached[v])
+                result.sourceSide.push_back(net.numbers[v]);
+
+        return result;
+    }
+
+
+    // MaxFlow__distances() sets every height to the number of residual
+    // arcs on a shortest path to the target that avoids the blocked
+    // vertex, or to unreachable if there is none, by a breadth-first
+    // search backward along residual arcs.
+    inline void MaxFlow__distances(
+        const MaxFlow__Network& net, int target, int blocked, int unreachable, std::vector<int>& height)
+    {
+        std::fill(height.begin(), height.end(), unreachable);
+        height[target] = 0;
+        height[blocked] = unreachable + 1;
+        std::vector<int> queue{target};
+        for(std::size_t q = 0; q < queue.size(); q++)
+        {
+            int v = queue[q];
+            for(int i = net.first[v]; i < net.first[v + 1]; i++)
+            {
+                // the arc u -> v is the partner of the arc v -> u
+                int a = net.arcsOf[i];
+                int u = net.head[a];
+                if(height[u] == unreachable && net.residual[a ^ 1] > 0.0)
+                {
+                    height[u] = height[v] + 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+    }
+
+
+    // MaxFlow__pushRelabel() runs one phase of FIFO push-relabel: it moves
+    // excess toward the target, never lifting a vertex above ceiling, and
+    // leaves excess that can't reach the target on vertices at ceiling.
+    inline void MaxFlow__pushRelabel(MaxFlow__Network& net, std::vector<double>& excess,
+                                     int target, int ceiling)
+    {
+        int n = net.n;
+        int other = target == net.sink ? net.source : net.sink;
+        std::vector<int> height(n);
+        std::vector<int> count(ceiling + 1, 0);
+        std::vector<int> current(n);
+        std::vector<char> queued(n, false);
+        std::vector<int> queue;
+        std::size_t front = 0;
+
+        // the source and sink are never relabeled; whichever one isn't
+        // the target sits at the ceiling so nothing flows back into it
+        auto globalRelabel = [&]()
+        {
+            MaxFlow__distances(net, target, other, ceiling, height);
+            height[other] = ceiling;
+            std::fill(count.begin(), count.end(), 0);
+            for(int v = 0; v < n; v++)
+                if(v != net.source && v != net.sink)
+                    count[height[v]]++;
+            for(int v = 0; v < n; v++)
+                current[v] = net.first[v];
+        };
+
+        globalRelabel();
+
+        for(int v = 0; v < n; v++)
+        {
+            if(excess[v] > 0.0 && v != net.source && v != net.sink && height[v] < ceiling)
+            {
+                queued[v] = true;
+                queue.push_back(v);
+            }
+        }
+
+        long long work = 0;
+        long long relabelEvery = 6LL * n + static_cast<long long>(net.head.size()) / 2;
+
+        while(front < queue.size())
+        {
+            int v = queue[front++];
+            queued[v] = false;
+
+            while(excess[v] > 0.0 && height[v] < ceiling)
+            {
+                if(current[v] == net.first[v + 1])
+                {
+                    // relabel: one above the lowest admissible neighbor
+                    int lowest = ceiling;
+                    for(int i = net.first[v]; i < net.first[v + 1]; i++)
+                    {
+                        int a = net.arcsOf[i];
+                        if(net.residual[a] > 0.0)
+                            lowest = std::min(lowest, height[net.head[a]] + 1);
+                    }
+                    int old = height[v];
+                    height[v] = std::min(lowest, ceiling);
+                    current[v] = net.first[v];
+                    work += net.first[v + 1] - net.first[v] + 12;
+
+                    count[old]--;
+                    count[height[v]]++;
+                    if(count[old] == 0)
+                    {
+                        // gap: nothing at this height, so nothing above it
+                        // can reach the target any more
+                        for(int u = 0; u < n; u++)
+                        {
+                            if(height[u] > old && height[u] < ceiling && u != net.source && u != net.sink)
+                            {
+                                count[height[u]]--;
+                                height[u] = ceiling;
+                                count[ceiling]++;
+                            }
+                        }
+                    }
+                    continue;
+                }
+
+                int a = net.arcsOf[current[v]];
+                int w = net.head[a];
+                if(net.residual[a] > 0.0 && height[v] == height[w] + 1)
+                {
+                    double delta = std::min(excess[v], net.residual[a]);
+                    net.residual[a] -= delta;
+                    net.residual[a ^ 1] += delta;
+                    excess[v] -= delta;
+                    excess[w] += delta;
+                    if(!queued[w] && w != net.source && w != net.sink && height[w] < ceiling)
+                    {
+                        queued[w] = true;
+                        queue.push_back(w);
+                    }
+                }
+                else
+                    current[v]++;
+            }
+
+            if(work > relabelEvery)
+            {
+                work = 0;
+                globalRelabel();
+            }
+
+            // keep the queue from growing without bound
+            if(front > queue.size() / 2 && front > 1024)
+            {
+                queue.erase(queue.begin(), queue.begin() + front);
+                front = 0;
+            }
+        }
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename CapacityFunc>
+MaxFlowResult maxFlowPushRelabel(
+    const Digraph<VertexInfo, EdgeInfo>& d, int sourceVertex, int sinkVertex, CapacityFunc capacityFunc)
+{
+    impl_::MaxFlow__Network net = impl_::MaxFlow__build(
+        d, sourceVertex, sinkVertex, capacityFunc, "maxFlowPushRelabel");
+    int n = net.n;
+
+    // saturate every edge out of the source to start the preflow
+    std::vector<double> excess(n, 0.0);
+    for(int i = net.first[net.source]; i < net.first[net.source + 1]; i++)
+    {
+        int a = net.arcsOf[i];
+        double c = net.residual[a];
+        net.residual[a] = 0.0;
+        net.residual[a ^ 1] += c;
+        excess[net.head[a]] += c;
+        excess[net.source] -= c;
+    }
+
+    // first, send as much excess as possible to the sink, which already
+    // determines the flow value and the minimum cut...
+    impl_::MaxFlow__pushRelabel(net, excess, net.sink, n);
+
+    // ...then return what is left over to the source, which turns the
+    // preflow into a flow
+    impl_::MaxFlow__pushRelabel(net, excess, net.source, n);
+
+    return impl_::MaxFlow__finish(net);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename CapacityFunc>
+MaxFlowResult maxFlowDinic(
+    const Digraph<VertexInfo, EdgeInfo>& d, int sourceVertex, int sinkVertex, CapacityFunc capacityFunc)
+{
+    impl_::MaxFlow__Network net = impl_::MaxFlow__build(
+        d, sourceVertex, sinkVertex, capacityFunc, "maxFlowDinic");
+    int n = net.n;
+    int s = net.source;
+    int t = net.sink;
+
+    std::vector<int> level(n);
+    std::vector<int> current(n);
+    std::vector<int> path;
+
+    while(true)
+    {
+        // level graph: arcs that go one level further from the source
+        std::fill(level.begin(), level.end(), -1);
+        level[s] = 0;
+        std::vector<int> queue{s};
+        for(std::size_t q = 0; q < queue.size() && level[t] == -1; q++)
+        {
+            int v = queue[q];
+            for(int i = net.first[v]; i < net.first[v + 1]; i++)
+            {
+                int a = net.arcsOf[i];
+                if(net.residual[a] > 0.0 && level[net.head[a]] == -1)
+                {
+                    level[net.head[a]] = level[v] + 1;
+                    queue.push_back(net.head[a]);
+                }
+            }
+        }
+        if(level[t] == -1)
+            break;
+
+        // blocking flow, by depth-first search that keeps its place in each
+        // vertex's arcs and abandons dead ends for the rest of the phase
+        for(int v = 0; v < n; v++)
+            current[v] = net.first[v];
+        path.clear();
+        int v = s;
+        while(true)
+        {
+            if(v == t)
+            {
+                double delta = std::numeric_limits<double>::infinity();
+                for(int a : path)
+                    delta = std::min(delta, net.residual[a]);
+                std::size_t retreat = path.size();
+                for(std::size_t k = 0; k < path.size(); k++)
+                {
+                    net.residual[path[k]] -= delta;
+                    net.residual[path[k] ^ 1] += delta;
+                    if(retreat == path.size() && net.residual[path[k]] <= 0.0)
+                        retreat = k;
+                }
+                path.resize(retreat);
+                v = path.empty() ? s : net.head[path.back()];
+                continue;
+            }
+
+            bool advanced = false;
+            for(; current[v] < net.first[v + 1]; current[v]++)
+            {
+                int a = net.arcsOf[current[v]];
+                int w = net.head[a];
+                if(net.residual[a] > 0.0 && level[w] == level[v] + 1)
+                {
+                    path.push_back(a);
+                    v = w;
+                    advanced = true;
+                    break;
+                }
+            }
+            if(advanced)
+                continue;
+
+            // dead end
+            level[v] = -1;
+            if(path.empty())
+                break;
+            int a = path.back();
+            path.pop_back();
+            v = net.head[a ^ 1];
+            current[v]++;
+        }
+    }
+
+    return impl_::MaxFlow__finish(net);
+}
+
+
+
+#endif // MAXFLOW_HPP
@@ -0,0 +1,240 @@
+// PackedGraph.hpp
+//
+//
+// A PackedGraph is a read-only copy of a Digraph stored as a "structure
+// of arrays": the topology is a CSRGraph snapshot, whose edge targets are
+// packed into one array of ints, and the EdgeInfo of every edge lives in
+// a separate array in the same order (likewise the VertexInfo of every
+// vertex, by dense index).
+//
+// A Digraph keeps each edge's vertex numbers and EdgeInfo together in a
+// list node, so a traversal that only follows edges (such as the one
+// behind isStronglyConnected()) pulls every EdgeInfo through the cache
+// along with them.  Here, a traversal touches only the targets, and an
+// algorithm that needs edge weights gets them as one more packed array
+// from weighted(), computed once in a single pass over the EdgeInfo array
+// rather than by calling the weight function on every visit.
+//
+// This is the in-memory counterpart of a MappedGraph (see GraphFile.hpp),
+// without the requirement that VertexInfo and EdgeInfo be trivially
+// copyable.
+//
+
+#ifndef PACKEDGRAPH_HPP
+#define PACKEDGRAPH_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "DeltaStepping.hpp"
+#include "Digraph.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class PackedGraph
+{
+public:
+    // Copies the given Digraph.  Vertices get the same dense indices as in
+    // a CSRGraph snapshot, and edges keep the order of each vertex's edge
+    // list.
+    explicit PackedGraph(const Digraph<VertexInfo, EdgeInfo>& d);
+
+    // topology() returns the unweighted CSRGraph of the vertices and
+    // edges.
+    const CSRGraph& topology() const noexcept;
+
+    // vertexCount() and edgeCount() return the number of vertices and
+    // edges.
+    int vertexCount() const noexcept;
+    int edgeCount() const noexcept;
+
+    // vertexInfo() returns the VertexInfo of the vertex with the given
+    // dense index.
+    const VertexInfo& vertexInfo(int index) const;
+
+    // edgeInfo() returns the EdgeInfo of the edge at the given position
+    // in topology().targets().
+    const EdgeInfo& edgeInfo(int edgeIndex) const;
+
+    // edgeInfos() returns the EdgeInfo of every edge, in the same order as
+    // topology().targets().
+    const std::vector<EdgeInfo>& edgeInfos() const noexcept;
+
+    // weighted() returns a snapshot of the topology with the weight
+    // determined by edgeWeightFunc stored for each edge, ready for
+    // deltaStepping() and the other weighted algorithms.  Keeping it
+    // around saves recomputing the weights for every call.
+    template <typename EdgeWeightFunc>
+    CSRGraph weighted(EdgeWeightFunc edgeWeightFunc) const;
+
+    // isStronglyConnected() returns true if every vertex is reachable from
+    // every other, just as Digraph::isStronglyConnected() does.
+    bool isStronglyConnected() const;
+
+    // findShortestPaths() returns the same predecessors as
+    // Digraph::findShortestPaths(), keyed by vertex number, computed with
+    // deltaStepping() over weighted() using the given number of threads
+    // (zero meaning one per hardware thread).
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, EdgeWeightFunc edgeWeightFunc, unsigned int threads = 0) const;
+
+    // This overload of findShortestPaths() uses a snapshot already made
+    // by weighted(), so that repeated queries with the same weights don't
+    // compute them again.  If the snapshot has no weights or doesn't
+    // match this PackedGraph's size, a DigraphException is thrown
+    // instead.
+    std::map<int, int> findShortestPaths(
+        int startVertex, const CSRGraph& weightedGraph, unsigned int threads = 0) const;
+
+private:
+    CSRGraph graph;
+    std::vector<VertexInfo> vinfos;
+    std::vector<EdgeInfo> einfos;
+};
+
+
+
+namespace impl_
+{
+    // PackedGraph__reachesAll() returns true if every vertex of g can be
+    // reached from the vertex with dense index 0.
+    inline bool PackedGraph__reachesAll(const CSRGraph& g)
+    {
+        int n = g.vertexCount();
+        const CSRArray<int>& offsets = g.offsets();
+        const CSRArray<int>& targets = g.targets();
+
+        std::vector<char> visited(n, false);
+        std::vector<int> stack{0};
+        visited[0] = true;
+        int reached = 1;
+        while(!stack.empty())
+        {
+            int v = stack.back();
+            stack.pop_back();
+            for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            {
+                int w = targets[i];
+                if(!visited[w])
+                {
+                    visited[w] = true;
+                    reached++;
+                    stack.push_back(w);
+                }
+            }
+        }
+        return reached == n;
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+PackedGraph<VertexInfo, EdgeInfo>::PackedGraph(const Digraph<VertexInfo, EdgeInfo>& d)
+    : graph{d}
+{
+    vinfos.reserve(d.vertexCount());
+    einfos.reserve(d.edgeCount());
+    for(int vertex : d.vertexView())
+    {
+        vinfos.push_back(d.vertexInfo(vertex));
+        for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertex))
+            einfos.push_back(e.einfo);
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const CSRGraph& PackedGraph<VertexInfo, EdgeInfo>::topology() const noexcept
+{
+    return graph;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int PackedGraph<VertexInfo, EdgeInfo>::vertexCount() const noexcept
+{
+    return graph.vertexCount();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int PackedGraph<VertexInfo, EdgeInfo>::edgeCount() const noexcept
+{
+    return graph.edgeCount();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo& PackedGraph<VertexInfo, EdgeInfo>::vertexInfo(int index) const
+{
+    return vinfos[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& PackedGraph<VertexInfo, EdgeInfo>::edgeInfo(int edgeIndex) const
+{
+    return einfos[edgeIndex];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const std::vector<EdgeInfo>& PackedGraph<VertexInfo, EdgeInfo>::edgeInfos() const noexcept
+{
+    return einfos;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+CSRGraph PackedGraph<VertexInfo, EdgeInfo>::weighted(EdgeWeightFunc edgeWeightFunc) const
+{
+    std::vector<double> weights;
+    weights.reserve(einfos.size());
+    for(const EdgeInfo& einfo : einfos)
+        weights.push_back(edgeWeightFunc(einfo));
+    return graph.withWeights(std::move(weights));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool PackedGraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
+{
+    // strongly connected exactly when one vertex reaches every other
+    // and every other reaches it
+    if(graph.vertexCount() == 0)
+        return true;
+    return impl_::PackedGraph__reachesAll(graph)
+        && impl_::PackedGraph__reachesAll(graph.transpose());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> PackedGraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex, EdgeWeightFunc edgeWeightFunc, unsigned int threads) const
+{
+    return findShortestPaths(startVertex, weighted(edgeWeightFunc), threads);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> PackedGraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex, const CSRGraph& weightedGraph, unsigned int threads) const
+{
+    if(weightedGraph.vertexCount() != graph.vertexCount() || weightedGraph.edgeCount() != graph.edgeCount())
+        throw DigraphException{std::string("When PackedGraph findShortestPaths, snapshot doesn't match!")};
+    ShortestPathTree tree = deltaStepping(weightedGraph, startVertex, 0.0, threads);
+
+    std::map<int, int> ans;
+    for(int i = 0; i < graph.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), graph.vertexNumber(i), graph.vertexNumber(tree.predecessor[i]));
+    return ans;
+}
+
+
+
+#endif // PACKEDGRAPH_HPP
@@ -0,0 +1,211 @@
+// PageRank.hpp
+//
+//
+// A multi-threaded PageRank (and personalized PageRank) over a CSRGraph
+// snapshot.
+//
+// Each iteration is "pull-based": every vertex sums the contributions of
+// the vertices with edges into it, read from the transposed snapshot, so
+// each thread writes only the ranks of its own vertices and no atomics
+// are needed.  Ranks and contributions are kept in contiguous float
+// arrays, which halves the memory traffic compared to doubles and lets
+// the compiler vectorize the per-vertex loops; the sums that decide
+// convergence are accumulated in double.
+//
+// A vertex without outgoing edges ("dangling") hands its rank back to
+// the teleport distribution, so the ranks always sum to one.
+//
+
+#ifndef PAGERANK_HPP
+#define PAGERANK_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// pageRank() computes the PageRank of every vertex of g, indexed by dense
+// vertex index.  transposed must be g.transpose().  damping is the chance
+// of following an edge rather than teleporting to a random vertex, and
+// iteration stops once the ranks change by less than tolerance in total
+// (L1 distance) or after maxIterations iterations.  A thread count of
+// zero uses one per hardware thread.  If transposed does not match g or
+// damping is not between 0 and 1, a DigraphException is thrown instead.
+std::vector<float> pageRank(
+    const CSRGraph& g, const CSRGraph& transposed, double damping = 0.85,
+    double tolerance = 1e-6, int maxIterations = 100, unsigned int threads = 0);
+
+
+// personalizedPageRank() is like pageRank(), except that teleporting
+// always lands on one of the seed vertices (given by vertex number),
+// chosen uniformly, so the ranks measure closeness to the seed set.  If
+// a seed does not exist or there are no seeds, a DigraphException is
+// thrown instead.
+std::vector<float> personalizedPageRank(
+    const CSRGraph& g, const CSRGraph& transposed, const std::vector<int>& seeds,
+    double damping = 0.85, double tolerance = 1e-6, int maxIterations = 100,
+    unsigned int threads = 0);
+
+
+// This overload of pageRank() snapshots the given Digraph, runs
+// pageRank(), and returns the rank of every vertex keyed by vertex number.
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, double> pageRank(
+    const Digraph<VertexInfo, EdgeInfo>& d, double damping = 0.85,
+    double tolerance = 1e-6, int maxIterations = 100, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    // PageRank__iterate() runs the power iteration with the given teleport
+    // distribution, which must sum to one.
+    inline std::vector<float> PageRank__iterate(
+        const CSRGraph& g, const CSRGraph& transposed, const std::vector<float>& teleport,
+        double damping, double tolerance, int maxIterations, unsigned int threads,
+        const std::string& caller)
+    {
+        int n = g.vertexCount();
+        if(transposed.vertexCount() != n || transposed.edgeCount() != g.edgeCount())
+            throw DigraphException{std::string("When ") + caller + ", transposed doesn't match the graph!"};
+        if(!(damping >= 0.0 && damping <= 1.0))
+            throw DigraphException{std::string("When ") + caller + ", damping must be between 0 and 1!"};
+
+        threads = std::min<unsigned int>(resolveThreadCount(threads), std::max(n, 1));
+        long long chunk = (static_cast<long long>(n) + threads - 1) / threads;
+
+        const CSRArray<int>& outOffsets = g.offsets();
+        const CSRArray<int>& inOffsets = transposed.offsets();
+        const CSRArray<int>& inSources = transposed.targets();
+
+        std::vector<float> rank(teleport);
+        std::vector<float> next(n);
+        std::vector<float> contribution(n);
+        std::vector<double> dangling(threads);
+        std::vector<double> change(threads);
+        float d = static_cast<float>(damping);
+
+        Barrier barrier{threads};
+        bool swapped = false;
+
+        // the workers are started once, and every thread works out the same
+        // spread and stopping decision from the per-thread sums, between
+        // barriers; each keeps its own view of which buffer holds the ranks
+        runThreads(threads, [&](unsigned int t)
+        {
+            std::vector<float>* current = &rank;
+            std::vector<float>* following = &next;
+            long long lo = t * chunk;
+            long long hi = std::min<long long>(n, lo + chunk);
+
+            for(int iteration = 0; iteration < maxIterations; iteration++)
+            {
+                const std::vector<float>& r = *current;
+                std::vector<float>& out = *following;
+
+                double lost = 0.0;
+                for(long long v = lo; v < hi; v++)
+                {
+                    int degree = outOffsets[v + 1] - outOffsets[v];
+                    if(degree == 0)
+                    {
+                        lost += r[v];
+                        contribution[v] = 0.0f;
+                    }
+                    else
+                        contribution[v] = r[v] / degree;
+                }
+                dangling[t] = lost;
+                barrier.wait();
+
+                double lostTotal = 0.0;
+                for(double x : dangling)
+                    lostTotal += x;
+                // teleporting and dangling rank both follow the teleport vector
+                float spread = static_cast<float>((1.0 - damping) + damping * lostTotal);
+
+                double diff = 0.0;
+                for(long long v = lo; v < hi; v++)
+                {
+                    float sum = 0.0f;
+                    for(int i = inOffsets[v]; i < inOffsets[v + 1]; i++)
+                        sum += contribution[inSources[i]];
+                    out[v] = spread * teleport[v] + d * sum;
+                    diff += std::fabs(out[v] - r[v]);
+                }
+                change[t] = diff;
+                barrier.wait();
+
+                std::swap(current, following);
+                double total = 0.0;
+                for(double x : change)
+                    total += x;
+                barrier.wait();
+                if(total < tolerance)
+                    break;
+            }
+
+            if(t == 0)
+                swapped = current != &rank;
+        });
+
+        if(swapped)
+            rank.swap(next);
+        return rank;
+    }
+}
+
+
+inline std::vector<float> pageRank(
+    const CSRGraph& g, const CSRGraph& transposed, double damping,
+    double tolerance, int maxIterations, unsigned int threads)
+{
+    int n = g.vertexCount();
+    std::vector<float> teleport(n, n == 0 ? 0.0f : 1.0f / n);
+    return impl_::PageRank__iterate(g, transposed, teleport, damping, tolerance,
+                                    maxIterations, threads, "pageRank");
+}
+
+
+inline std::vector<float> personalizedPageRank(
+    const CSRGraph& g, const CSRGraph& transposed, const std::vector<int>& seeds,
+    double damping, double tolerance, int maxIterations, unsigned int threads)
+{
+    if(seeds.empty())
+        throw DigraphException{std::string("When personalizedPageRank, no seed vertices!")};
+
+    std::vector<float> teleport(g.vertexCount(), 0.0f);
+    for(int seed : seeds)
+        teleport[g.indexOf(seed)] = 1.0f;
+
+    float seedCount = std::count(teleport.begin(), teleport.end(), 1.0f);
+    for(float& x : teleport)
+        x /= seedCount;
+
+    return impl_::PageRank__iterate(g, transposed, teleport, damping, tolerance,
+                                    maxIterations, threads, "personalizedPageRank");
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, double> pageRank(
+    const Digraph<VertexInfo, EdgeInfo>& d, double damping,
+    double tolerance, int maxIterations, unsigned int threads)
+{
+    CSRGraph g{d};
+    std::vector<float> rank = pageRank(g, g.transpose(), damping, tolerance, maxIterations, threads);
+
+    std::map<int, double> ans;
+    for(int i = 0; i < g.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), g.vertexNumber(i), rank[i]);
+    return ans;
+}
+
+
+
+#endif // PAGERANK_HPP
@@ -0,0 +1,148 @@
+// Parallel.hpp
+//
+//
+// A few small threading utilities shared by the parallel graph algorithms.
+// They are built directly on std::thread so that nothing beyond the
+// standard library (and linking with -pthread) is needed.
+//
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// resolveThreadCount() turns a requested thread count into an actual one:
+// zero means "one per hardware thread", and the result is never below one.
+inline unsigned int resolveThreadCount(unsigned int threads)
+{
+    if(threads == 0)
+        threads = std::thread::hardware_concurrency();
+    return std::max(threads, 1u);
+}
+
+
+// A Barrier blocks each of a fixed number of threads in wait() until all
+// of them have arrived, and can then be reused for the next phase.
+
+class Barrier
+{
+public:
+    explicit Barrier(unsigned int count);
+
+    void wait();
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    unsigned int count;
+    unsigned int waiting = 0;
+    unsigned int generation = 0;
+};
+
+
+inline Barrier::Barrier(unsigned int count)
+    : count{count}
+{
+}
+
+
+inline void Barrier::wait()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    unsigned int gen = generation;
+    if(++waiting == count)
+    {
+        waiting = 0;
+        generation++;
+        cv.notify_all();
+    }
+    else
+        cv.wait(lock, [&]{ return gen != generation; });
+}
+
+
+// runThreads() calls func(t) for t = 0 .. threads - 1, each on its own
+// thread (the calling thread runs t = 0), and returns once all are done.
+template <typename Func>
+void runThreads(unsigned int threads, Func func)
+{
+    std::vector<std::thread> workers;
+    for(unsigned int t = 1; t < threads; t++)
+        workers.emplace_back(func, t);
+    func(0u);
+    for(std::thread& w : workers)
+        w.join();
+}
+
+
+// parallelFor() splits [begin, end) into contiguous blocks and calls
+// func(i) for every i, using up to the given number of threads (zero
+// meaning one per hardware thread).
+template <typename Func>
+void parallelFor(long long begin, long long end, unsigned int threads, Func func)
+{
+    if(end <= begin)
+        return;
+    threads = std::min<long long>(resolveThreadCount(threads), end - begin);
+    long long chunk = (end - begin + threads - 1) / threads;
+    runThreads(threads, [&](unsigned int t)
+    {
+        long long lo = begin + t * chunk;
+        long long hi = std::min(end, lo + chunk);
+        for(long long i = lo; i < hi; i++)
+            func(i);
+    });
+}
+
+
+
+// parallelSort() sorts [first, last) with the given comparison, sorting
+// one contiguous block per thread and then merging neighboring blocks
+// pairwise (each round of merges also runs in parallel).
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, unsigned int threads = 0)
+{
+    long long size = last - first;
+    threads = resolveThreadCount(threads);
+    if(threads == 1 || size < 2 * static_cast<long long>(threads))
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    long long block = (size + threads - 1) / threads;
+    std::vector<long long> bounds;
+    for(long long b = 0; b < size; b += block)
+        bounds.push_back(b);
+    bounds.push_back(size);
+
+    parallelFor(0, bounds.size() - 1, threads, [&](long long i)
+    {
+        std::sort(first + bounds[i], first + bounds[i + 1], comp);
+    });
+
+    while(bounds.size() > 2)
+    {
+        long long blocks = bounds.size() - 1;
+        parallelFor(0, blocks / 2, threads, [&](long long i)
+        {
+            std::inplace_merge(first + bounds[2 * i], first + bounds[2 * i + 1],
+                               first + bounds[2 * i + 2], comp);
+        });
+
+        std::vector<long long> merged;
+        for(long long i = 0; i < blocks; i += 2)
+            merged.push_back(bounds[i]);
+        merged.push_back(size);
+        bounds.swap(merged);
+    }
+}
+
+
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,255 @@
+// Reordering.hpp
+//
+//
+// Vertex orders that improve the memory locality of a CSRGraph snapshot,
+// and a simple k-way partitioner for splitting a graph among workers.
+//
+// A CSRGraph's dense indices follow vertex numbers, which usually say
+// nothing about which vertices are near one another, so a traversal's
+// next vertex is often far away in memory.  The orders here are returned
+// as a newIndex array (the new dense index of every current one), ready
+// to pass to CSRGraph::reorder():
+//
+//   * reverseCuthillMcKee() numbers vertices in breadth-first order,
+//     visiting each vertex's neighbors from lowest to highest degree, and
+//     then reverses the whole order.  Neighboring vertices end up with
+//     nearby indices, which suits BFS, Dijkstra and anything else that
+//     walks from a vertex to its neighbors.
+//
+//   * degreeOrder() moves the vertices with the most edges to the front,
+//     so that the "hub" vertices most traversals keep coming back to are
+//     packed into as few cache lines as possible.
+//
+// partitionGraph() streams the vertices, in breadth-first order, into k
+// parts of at most a given size, putting each one into the part that
+// already holds most of its neighbors (the "linear deterministic greedy"
+// rule, which weighs that against how full the part is).
+//
+// All of these ignore edge directions.
+//
+
+#ifndef REORDERING_HPP
+#define REORDERING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// reverseCuthillMcKee() returns the reverse Cuthill-McKee order of g as a
+// newIndex array.
+std::vector<int> reverseCuthillMcKee(const CSRGraph& g);
+
+
+// degreeOrder() returns, as a newIndex array, the order of g's vertices
+// by decreasing number of edges (in and out), breaking ties by dense
+// index, sorting with the given number of threads (zero meaning one per
+// hardware thread).
+std::vector<int> degreeOrder(const CSRGraph& g, unsigned int threads = 0);
+
+
+// partitionGraph() splits g into the given number of parts, none of them
+// with more than imbalance times its share of the vertices, and returns
+// the part (from 0 to parts - 1) of every vertex by dense index.  If parts
+// is not positive or imbalance is below one, a DigraphException is thrown
+// instead.
+std::vector<int> partitionGraph(const CSRGraph& g, int parts, double imbalance = 1.05);
+
+
+// edgeCut() returns the number of edges of g whose ends are in different
+// parts, given the part of every vertex by dense index.
+long long edgeCut(const CSRGraph& g, const std::vector<int>& part);
+
+
+
+namespace impl_
+{
+    // Reordering__Symmetric holds both the outgoing and the incoming edges
+    // of every vertex of a CSRGraph, as one list per vertex.
+    struct Reordering__Symmetric
+    {
+        std::vector<int> offsets;
+        std::vector<int> neighbors;
+    };
+
+
+    inline Reordering__Symmetric Reordering__symmetric(const CSRGraph& g)
+    {
+        int n = g.vertexCount();
+        CSRGraph transposed = g.transpose();
+        const CSRArray<int>& outOffsets = g.offsets();
+        const CSRArray<int>& outTargets = g.targets();
+        const CSRArray<int>& inOffsets = transposed.offsets();
+        const CSRArray<int>& inSources = transposed.targets();
+
+        Reordering__Symmetric sym;
+        sym.offsets.resize(n + 1);
+        sym.neighbors.reserve(2 * static_cast<std::size_t>(g.edgeCount()));
+        sym.offsets[0] = 0;
+        for(int v = 0; v < n; v++)
+        {
+            sym.neighbors.insert(sym.neighbors.end(), outTargets.begin() + outOffsets[v], outTargets.begin() + outOffsets[v + 1]);
+            sym.neighbors.insert(sym.neighbors.end(), inSources.begin() + inOffsets[v], inSources.begin() + inOffsets[v + 1]);
+            sym.offsets[v + 1] = sym.neighbors.size();
+        }
+        return sym;
+    }
+
+
+    // Reordering__cuthillMcKee() returns the vertices in Cuthill-McKee
+    // order: breadth-first, starting each component at one of its
+    // vertices of lowest degree and visiting neighbors from lowest to
+    // highest degree.
+    inline std::vector<int> Reordering__cuthillMcKee(const Reordering__Symmetric& sym)
+    {
+        int n = sym.offsets.size() - 1;
+        auto degree = [&](int v) { return sym.offsets[v + 1] - sym.offsets[v]; };
+        auto byDegree = [&](int a, int b)
+        {
+            return degree(a) != degree(b) ? degree(a) < degree(b) : a < b;
+        };
+
+        std::vector<int> starts(n);
+        for(int v = 0; v < n; v++)
+            starts[v] = v;
+        std::sort(starts.begin(), starts.end(), byDegree);
+
+        std::vector<int> order;
+        order.reserve(n);
+        std::vector<char> visited(n, false);
+        for(int s : starts)
+        {
+            if(visited[s])
+                continue;
+            visited[s] = true;
+            order.push_back(s);
+
+            // order doubles as the queue
+            for(std::size_t head = order.size() - 1; head < order.size(); head++)
+            {
+                int v = order[head];
+                std::size_t first = order.size();
+                for(int i = sym.offsets[v]; i < sym.offsets[v + 1]; i++)
+                {
+                    int w = sym.neighbors[i];
+                    if(!visited[w])
+                    {
+                        visited[w] = true;
+                        order.push_back(w);
+                    }
+                }
+                std::sort(order.begin() + first, order.end(), byDegree);
+            }
+        }
+        return order;
+    }
+}
+
+
+inline std::vector<int> reverseCuthillMcKee(const CSRGraph& g)
+{
+    int n = g.vertexCount();
+    std::vector<int> order = impl_::Reordering__cuthillMcKee(impl_::Reordering__symmetric(g));
+
+    std::vector<int> newIndex(n);
+    for(int k = 0; k < n; k++)
+        newIndex[order[k]] = n - 1 - k;
+    return newIndex;
+}
+
+
+inline std::vector<int> degreeOrder(const CSRGraph& g, unsigned int threads)
+{
+    int n = g.vertexCount();
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+
+    std::vector<int> degree(n);
+    for(int v = 0; v < n; v++)
+        degree[v] = offsets[v + 1] - offsets[v];
+    for(int t : targets)
+        degree[t]++;
+
+    std::vector<int> order(n);
+    for(int v = 0; v < n; v++)
+        order[v] = v;
+    parallelSort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return degree[a] != degree[b] ? degree[a] > degree[b] : a < b;
+    }, threads);
+
+    std::vector<int> newIndex(n);
+    for(int k = 0; k < n; k++)
+        newIndex[order[k]] = k;
+    return newIndex;
+}
+
+
+inline std::vector<int> partitionGraph(const CSRGraph& g, int parts, double imbalance)
+{
+    if(parts <= 0)
+        throw DigraphException{std::string("When partitionGraph, number of parts is not positive!")};
+    if(!(imbalance >= 1.0))
+        throw DigraphException{std::string("When partitionGraph, imbalance is below one!")};
+
+    int n = g.vertexCount();
+    impl_::Reordering__Symmetric sym = impl_::Reordering__symmetric(g);
+    std::vector<int> order = impl_::Reordering__cuthillMcKee(sym);
+
+    double capacity = std::max(1.0, std::ceil(imbalance * n / parts));
+    std::vector<int> part(n, -1);
+    std::vector<int> size(parts, 0);
+    std::vector<int> neighborsIn(parts, 0);
+
+    for(int v : order)
+    {
+        for(int i = sym.offsets[v]; i < sym.offsets[v + 1]; i++)
+            if(part[sym.neighbors[i]] != -1)
+                neighborsIn[part[sym.neighbors[i]]]++;
+
+        // the most neighbors, discounted by fullness; ties go to the
+        // emptier part, so that vertices with no placed neighbors spread out
+        int best = -1;
+        double bestScore = 0.0;
+        for(int p = 0; p < parts; p++)
+        {
+            if(size[p] >= capacity)
+                continue;
+            double score = neighborsIn[p] * (1.0 - size[p] / capacity);
+            if(best == -1 || score > bestScore || (score == bestScore && size[p] < size[best]))
+            {
+                best = p;
+                bestScore = score;
+            }
+        }
+
+        part[v] = best;
+        size[best]++;
+        for(int i = sym.offsets[v]; i < sym.offsets[v + 1]; i++)
+            if(part[sym.neighbors[i]] != -1)
+                neighborsIn[part[sym.neighbors[i]]] = 0;
+    }
+    return part;
+}
+
+
+inline long long edgeCut(const CSRGraph& g, const std::vector<int>& part)
+{
+    const CSRArray<int>& offsets = g.offsets();
+    const CSRArray<int>& targets = g.targets();
+
+    long long cut = 0;
+    for(int v = 0; v < g.vertexCount(); v++)
+        for(int i = offsets[v]; i < offsets[v + 1]; i++)
+            if(part[v] != part[targets[i]])
+                cut++;
+    return cut;
+}
+
+
+
+#endif // REORDERING_HPP
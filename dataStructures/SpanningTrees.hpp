@@ -0,0 +1,586 @@
+// SpanningTrees.hpp
+//
+//
+// Minimum spanning structures of a Digraph, with edge weights determined
+// by edgeWeightFunc exactly as in Digraph::findShortestPaths().  The
+// weight function is a template parameter, so a std::function works as
+// well as a lambda or functor the compiler can inline.
+//
+// Minimum spanning forests ignore edge directions (the "symmetric view"
+// of the Digraph, in which an edge from u to v also connects v to u); the
+// three algorithms find forests of the same total weight:
+//
+//   * kruskal() sorts all edges by weight, in parallel, and adds each one
+//     that joins two different trees, tracked with a union-find.
+//
+//   * prim() grows one tree at a time from its lightest outgoing edge,
+//     using a priority queue.
+//
+//   * boruvka() works in rounds: every tree picks its lightest outgoing
+//     edge (the edges are scanned in parallel), all of them are added at
+//     once, and the edges inside the merged trees are dropped.
+//
+// Each returns the chosen edges as pairs of "from" and "to" vertex
+// numbers, exactly as they appear in the Digraph.
+//
+// minimumSpanningArborescence() respects edge directions: it finds the
+// lightest set of edges by which every vertex can be reached from a root
+// (Edmonds' algorithm, in Tarjan's O(E log V) form with mergeable heaps).
+//
+
+#ifndef SPANNINGTREES_HPP
+#define SPANNINGTREES_HPP
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// A DisjointSets is a union-find over the elements 0 to n - 1: it keeps
+// them partitioned into sets, each identified by one of its elements.
+
+class DisjointSets
+{
+public:
+    // Initializes a DisjointSets with every element in a set by itself.
+    explicit DisjointSets(int n);
+
+    // find() returns the element that identifies the set containing the
+    // given element.
+    int find(int x);
+
+    // unite() merges the sets containing the two given elements, and
+    // returns false if they were already in the same set.
+    bool unite(int x, int y);
+
+private:
+    std::vector<int> parent;
+    std::vector<int> size;
+};
+
+
+// kruskal() returns a minimum spanning forest of the symmetric view of
+// the Digraph, sorting with the given number of threads (zero meaning
+// one per hardware thread).
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> kruskal(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc, unsigned int threads = 0);
+
+
+// prim() returns a minimum spanning forest of the symmetric view of the
+// Digraph.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> prim(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc);
+
+
+// boruvka() returns a minimum spanning forest of the symmetric view of
+// the Digraph, using the given number of threads (zero meaning one per
+// hardware thread).
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> boruvka(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc, unsigned int threads = 0);
+
+
+// minimumSpanningArborescence() returns, for every vertex, the "from"
+// vertex of the edge by which it is reached in a minimum spanning
+// arborescence rooted at the given vertex, keyed by vertex number; the
+// root is its own parent, following findShortestPaths().  If the root
+// does not exist or some vertex can't be reached from it, a
+// DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> minimumSpanningArborescence(
+    const Digraph<VertexInfo, EdgeInfo>& d, int rootVertex, EdgeWeightFunc edgeWeightFunc);
+
+
+
+inline DisjointSets::DisjointSets(int n)
+    : parent(n), size(n, 1)
+{
+    for(int i = 0; i < n; i++)
+        parent[i] = i;
+}
+
+
+inline int DisjointSets::find(int x)
+{
+    // path halving: point every other element on the way at its grandparent
+    while(parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+
+inline bool DisjointSets::unite(int x, int y)
+{
+    x = find(x);
+    y = find(y);
+    if(x == y)
+        return false;
+    if(size[x] < size[y])
+        std::swap(x, y);
+    parent[y] = x;
+    size[x] += size[y];
+    return true;
+}
+
+
+
+namespace impl_
+{
+    // SpanningTrees__Edges holds every edge of a Digraph in flat arrays,
+    // with its endpoints as dense indices (in increasing order of vertex
+    // number) and its weight.
+    struct SpanningTrees__Edges
+    {
+        std::vector<int> numbers;
+        std::vector<int> from;
+        std::vector<int> to;
+        std::vector<double> weight;
+    };
+
+
+    template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+    SpanningTrees__Edges SpanningTrees__collect(
+        const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc& edgeWeightFunc)
+    {
+        SpanningTrees__Edges edges;
+        edges.numbers.assign(d.vertexView().begin(), d.vertexView().end());
+        edges.from.reserve(d.edgeCount());
+        edges.to.reserve(d.edgeCount());
+        edges.weight.reserve(d.edgeCount());
+
+        int index = 0;
+        for(int vertex : d.vertexView())
+        {
+            for(const DigraphEdge<EdgeInfo>& e : d.edgeView(vertex))
+            {
+                edges.from.push_back(index);
+                edges.to.push_back(std::lower_bound(edges.numbers.begin(), edges.numbers.end(), e.toVertex)
+                                   - edges.numbers.begin());
+                edges.weight.push_back(edgeWeightFunc(e.einfo));
+            }
+            index++;
+        }
+        return edges;
+    }
+
+
+    inline std::pair<int, int> SpanningTrees__edge(const SpanningTrees__Edges& edges, int e)
+    {
+        return std::pair<int, int>{edges.numbers[edges.from[e]], edges.numbers[edges.to[e]]};
+    }
+
+
+    // SpanningTrees__lighter() orders edges by weight, breaking ties by
+    // position; a strict order like this is what keeps Boruvka's rounds
+    // from closing a cycle among equally heavy edges.
+    inline bool SpanningTrees__lighter(const SpanningTrees__Edges& edges, int a, int b)
+    {
+        if(edges.weight[a] != edges.weight[b])
+            return edges.weight[a] < edges.weight[b];
+        return a < b;
+    }
+
+
+    // A SpanningTrees__Heap is a skew heap of incoming edges with a lazy
+    // amount added to every weight in it, stored in a shared node pool.
+    struct SpanningTrees__HeapNode
+    {
+        int edge;
+        double key;
+        double lazy;
+        int left;
+        int right;
+    };
+
+
+    class SpanningTrees__Heaps
+    {
+    public:
+        explicit SpanningTrees__Heaps(std::size_t capacity)
+        {
+            nodes.reserve(capacity);
+        }
+
+        int make(int edge, double key)
+        {
+            nodes.push_back(SpanningTrees__HeapNode{edge, key, 0.0, -1, -1});
+            return nodes.size() - 1;
+        }
+
+        void push(int h)
+        {
+            SpanningTrees__HeapNode& node = nodes[h];
+            if(node.lazy != 0.0)
+            {
+                node.key += node.lazy;
+                if(node.left != -1)
+                    nodes[node.left].lazy += node.lazy;
+                if(node.right != -1)
+                    nodes[node.right].lazy += node.lazy;
+                node.lazy = 0.0;
+            }
+        }
+
+        int merge(int a, int b)
+        {
+            if(a == -1 || b == -1)
+                return a == -1 ? b : a;
+            push(a);
+            push(b);
+            if(nodes[b].key < nodes[a].key)
+                std::swap(a, b);
+            int merged = merge(b, nodes[a].right);
+            nodes[a].right = nodes[a].left;
+            nodes[a].left = merged;
+            return a;
+        }
+
+        int pop(int h)
+        {
+            push(h);
+            return merge(nodes[h].left, nodes[h].right);
+        }
+
+        SpanningTrees__HeapNode& top(int h)
+        {
+            push(h);
+            return nodes[h];
+        }
+
+        void add(int h, double amount)
+        {
+            nodes[h].lazy += amount;
+        }
+
+    private:
+        std::vector<SpanningTrees__HeapNode> nodes;
+    };
+
+
+    // SpanningTrees__RollbackSets is a union-find without path compression
+    // whose unions can be undone, newest first.
+    class SpanningTrees__RollbackSets
+    {
+    public:
+        explicit SpanningTrees__RollbackSets(int n)
+            : parent(n, -1)
+        {
+        }
+
+        int find(int x) const
+        {
+            while(parent[x] >= 0)
+                x = parent[x];
+            return x;
+        }
+
+        bool unite(int x, int y)
+        {
+            x = find(x);
+            y = find(y);
+            if(x == y)
+                return false;
+            if(parent[x] > parent[y])
+                std::swap(x, y);
+            history.push_back(std::pair<int, int>{x, parent[x]});
+            history.push_back(std::pair<int, int>{y, parent[y]});
+            parent[x] += parent[y];
+            parent[y] = x;
+            return true;
+        }
+
+        std::size_t time() const
+        {
+            return history.size();
+        }
+
+        void rollback(std::size_t t)
+        {
+            while(history.size() > t)
+            {
+                parent[history.back().first] = history.back().second;
+                history.pop_back();
+            }
+        }
+
+    private:
+        std::vector<int> parent;
+        std::vector<std::pair<int, int>> history;
+    };
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> kruskal(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc, unsigned int threads)
+{
+    impl_::SpanningTrees__Edges edges = impl_::SpanningTrees__collect(d, edgeWeightFunc);
+
+    std::vector<int> order(edges.from.size());
+    for(std::size_t e = 0; e < order.size(); e++)
+        order[e] = e;
+    parallelSort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return impl_::SpanningTrees__lighter(edges, a, b);
+    }, threads);
+
+    DisjointSets sets(edges.numbers.size());
+    std::vector<std::pair<int, int>> forest;
+    for(int e : order)
+    {
+        if(sets.unite(edges.from[e], edges.to[e]))
+        {
+            forest.push_back(impl_::SpanningTrees__edge(edges, e));
+            if(forest.size() + 1 == edges.numbers.size())
+                break;
+        }
+    }
+    return forest;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> prim(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc)
+{
+    impl_::SpanningTrees__Edges edges = impl_::SpanningTrees__collect(d, edgeWeightFunc);
+    int n = edges.numbers.size();
+    int m = edges.from.size();
+
+    // the symmetric view: every edge is listed at both of its endpoints
+    std::vector<int> first(n + 1, 0);
+    for(int e = 0; e < m; e++)
+    {
+        first[edges.from[e] + 1]++;
+        first[edges.to[e] + 1]++;
+    }
+    for(int v = 0; v < n; v++)
+        first[v + 1] += first[v];
+    std::vector<int> incident(2 * m);
+    std::vector<int> pos(first.begin(), first.end() - 1);
+    for(int e = 0; e < m; e++)
+    {
+        incident[pos[edges.from[e]]++] = e;
+        incident[pos[edges.to[e]]++] = e;
+    }
+
+    std::vector<char> inTree(n, false);
+    std::vector<std::pair<int, int>> forest;
+    typedef std::pair<double, int> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> pqueue;
+
+    for(int root = 0; root < n; root++)
+    {
+        if(inTree[root])
+            continue;
+
+        auto grow = [&](int v)
+        {
+            inTree[v] = true;
+            for(int i = first[v]; i < first[v + 1]; i++)
+            {
+                int e = incident[i];
+                int w = edges.from[e] == v ? edges.to[e] : edges.from[e];
+                if(!inTree[w])
+                    pqueue.push(QueueItem{edges.weight[e], e});
+            }
+        };
+
+        grow(root);
+        while(!pqueue.empty())
+        {
+            int e = pqueue.top().second;
+            pqueue.pop();
+            int v = inTree[edges.from[e]] ? edges.to[e] : edges.from[e];
+            if(inTree[v])
+                continue;
+            forest.push_back(impl_::SpanningTrees__edge(edges, e));
+            grow(v);
+        }
+    }
+    return forest;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::vector<std::pair<int, int>> boruvka(
+    const Digraph<VertexInfo, EdgeInfo>& d, EdgeWeightFunc edgeWeightFunc, unsigned int threads)
+{
+    impl_::SpanningTrees__Edges edges = impl_::SpanningTrees__collect(d, edgeWeightFunc);
+    int n = edges.numbers.size();
+    threads = resolveThreadCount(threads);
+
+    std::vector<int> live(edges.from.size());
+    for(std::size_t e = 0; e < live.size(); e++)
+        live[e] = e;
+
+    DisjointSets sets(n);
+    std::vector<int> tree(n);
+    std::vector<std::vector<int>> lightest(threads, std::vector<int>(n, -1));
+    std::vector<std::pair<int, int>> forest;
+
+    while(!live.empty())
+    {
+        for(int v = 0; v < n; v++)
+            tree[v] = sets.find(v);
+
+        // each thread finds the lightest edge out of every tree among its
+        // share of the edges, and the shares are combined afterward
+        long long chunk = (static_cast<long long>(live.size()) + threads - 1) / threads;
+        runThreads(threads, [&](unsigned int t)
+        {
+            std::vector<int>& best = lightest[t];
+            std::fill(best.begin(), best.end(), -1);
+            long long lo = t * chunk;
+            long long hi = std::min<long long>(live.size(), lo + chunk);
+            for(long long i = lo; i < hi; i++)
+            {
+                int e = live[i];
+                int a = tree[edges.from[e]];
+                int b = tree[edges.to[e]];
+                if(best[a] == -1 || impl_::SpanningTrees__lighter(edges, e, best[a]))
+                    best[a] = e;
+                if(best[b] == -1 || impl_::SpanningTrees__lighter(edges, e, best[b]))
+                    best[b] = e;
+            }
+        });
+
+        for(int v = 0; v < n; v++)
+        {
+            if(tree[v] != v)
+                continue;
+            int best = -1;
+            for(unsigned int t = 0; t < threads; t++)
+            {
+                int e = lightest[t][v];
+                if(e != -1 && (best == -1 || impl_::SpanningTrees__lighter(edges, e, best)))
+                    best = e;
+            }
+            if(best != -1 && sets.unite(edges.from[best], edges.to[best]))
+                forest.push_back(impl_::SpanningTrees__edge(edges, best));
+        }
+
+        // drop the edges that now lie inside a single tree
+        std::vector<int> remaining;
+        for(int e : live)
+            if(sets.find(edges.from[e]) != sets.find(edges.to[e]))
+                remaining.push_back(e);
+        live.swap(remaining);
+    }
+    return forest;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename EdgeWeightFunc>
+std::map<int, int> minimumSpanningArborescence(
+    const Digraph<VertexInfo, EdgeInfo>& d, int rootVertex, EdgeWeightFunc edgeWeightFunc)
+{
+    impl_::SpanningTrees__Edges edges = impl_::SpanningTrees__collect(d, edgeWeightFunc);
+    int n = edges.numbers.size();
+    int m = edges.from.size();
+
+    auto it = std::lower_bound(edges.numbers.begin(), edges.numbers.end(), rootVertex);
+    if(it == edges.numbers.end() || *it != rootVertex)
+        throw DigraphException{std::string("When minimumSpanningArborescence, rootVertex not found!")};
+    int root = it - edges.numbers.begin();
+
+    // heap[v] holds the edges into v (or, once v stands for a contracted
+    // cycle, into any vertex of it), keyed by weight less whatever has
+    // already been paid for the cycle
+    impl_::SpanningTrees__Heaps heaps(m);
+    std::vector<int> heap(n, -1);
+    for(int e = 0; e < m; e++)
+        if(edges.from[e] != edges.to[e])
+            heap[edges.to[e]] = heaps.merge(heap[edges.to[e]], heaps.make(e, edges.weight[e]));
+
+    impl_::SpanningTrees__RollbackSets sets(n);
+    std::vector<int> seen(n, -1);
+    std::vector<int> path(n);
+    std::vector<int> chosen(n);
+    std::vector<int> incoming(n, -1);
+    seen[root] = root;
+
+    struct Cycle
+    {
+        int vertex;
+        std::size_t time;
+        std::vector<int> edges;
+    };
+    std::vector<Cycle> cycles;
+
+    for(int s = 0; s < n; s++)
+    {
+        int u = s;
+        int length = 0;
+        while(seen[u] < 0)
+        {
+            if(heap[u] == -1)
+                throw DigraphException{std::string("When minimumSpanningArborescence, vertex not reachable from root!")};
+
+            // take the cheapest edge into u, and make the others relative to it
+            impl_::SpanningTrees__HeapNode& top = heaps.top(heap[u]);
+            int e = top.edge;
+            double key = top.key;
+            heaps.add(heap[u], -key);
+            heap[u] = heaps.pop(heap[u]);
+
+            chosen[length] = e;
+            path[length++] = u;
+            seen[u] = s;
+            u = sets.find(edges.from[e]);
+
+            if(seen[u] == s)
+            {
+                // the chosen edges closed a cycle, which becomes one vertex
+                int merged = -1;
+                int end = length;
+                std::size_t time = sets.time();
+                int w;
+                do
+                {
+                    w = path[--length];
+                    merged = heaps.merge(merged, heap[w]);
+                }
+                while(sets.unite(u, w));
+                u = sets.find(u);
+                heap[u] = merged;
+                seen[u] = -1;
+                cycles.push_back(Cycle{u, time, std::vector<int>(chosen.begin() + length, chosen.begin() + end)});
+            }
+        }
+        for(int i = 0; i < length; i++)
+            incoming[sets.find(edges.to[chosen[i]])] = chosen[i];
+    }
+
+    // expand the cycles, newest first: every edge of a cycle stays except
+    // the one into the vertex where the cycle is entered from outside
+    for(auto c = cycles.rbegin(); c != cycles.rend(); c++)
+    {
+        sets.rollback(c->time);
+        int entering = incoming[c->vertex];
+        for(int e : c->edges)
+            incoming[sets.find(edges.to[e])] = e;
+        incoming[sets.find(edges.to[entering])] = entering;
+    }
+
+    std::map<int, int> ans;
+    for(int v = 0; v < n; v++)
+        ans.emplace_hint(ans.end(), edges.numbers[v], v == root ? edges.numbers[v] : edges.numbers[edges.from[incoming[v]]]);
+    return ans;
+}
+
+
+
+#endif // SPANNINGTREES_HPP
@@ -0,0 +1,344 @@
+// Triangles.hpp
+//
+//
+// Triangle counting and local clustering coefficients over a CSRGraph
+// snapshot, multi-threaded.
+//
+// Both ignore edge directions (as in the "symmetric view" of
+// SpanningTrees.hpp), count two opposite edges between the same vertices
+// as one, and ignore edges from a vertex to itself, so a triangle is
+// simply three vertices that are all adjacent to one another.
+//
+// The work is done on a degree-ordered snapshot: vertices are ranked by
+// increasing degree, and every edge is kept only at its lower-ranked end,
+// with each vertex's list of higher-ranked neighbors sorted by rank.
+// Every triangle then turns up exactly once, as the intersection of the
+// lists of its two lower-ranked vertices, and no list is longer than
+// about the square root of twice the number of edges, however skewed the
+// degrees are.
+//
+// Lists are intersected four elements against four at a time: the
+// sixteen comparisons of a block don't depend on one another, so the
+// compiler can carry them out with vector (SIMD) instructions on any
+// target, without the code depending on one instruction set.
+//
+
+#ifndef TRIANGLES_HPP
+#define TRIANGLES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <vector>
+#include "CSRGraph.hpp"
+#include "Digraph.hpp"
+#include "Parallel.hpp"
+
+
+// triangleCount() returns the number of triangles in g, using the given
+// number of threads (zero meaning one per hardware thread).
+long long triangleCount(const CSRGraph& g, unsigned int threads = 0);
+
+
+// localTriangleCounts() returns, for every vertex of g by dense index,
+// the number of triangles it belongs to.
+std::vector<long long> localTriangleCounts(const CSRGraph& g, unsigned int threads = 0);
+
+
+// localClusteringCoefficients() returns, for every vertex of g by dense
+// index, the fraction of pairs of its neighbors that are adjacent to one
+// another (zero for a vertex with fewer than two neighbors).
+std::vector<double> localClusteringCoefficients(const CSRGraph& g, unsigned int threads = 0);
+
+
+// These overloads snapshot a Digraph first; clustering coefficients are
+// keyed by vertex number.
+template <typename VertexInfo, typename EdgeInfo>
+long long triangleCount(const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads = 0);
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, double> localClusteringCoefficients(
+    const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads = 0);
+
+
+
+namespace impl_
+{
+    // Triangles__Oriented is the degree-ordered snapshot: vertex r is the
+    // vertex of rank r, whose higher-ranked neighbors (as ranks, in
+    // increasing order) are targets[offsets[r]] through
+    // targets[offsets[r + 1] - 1].  byRank maps ranks back to dense
+    // indices and degree holds the number of distinct neighbors of each
+    // dense index.
+    struct Triangles__Oriented
+    {
+        std::vector<long long> offsets;
+        std::vector<int> targets;
+        std::vector<int> byRank;
+        std::vector<int> degree;
+    };
+
+
+    // Triangles__forEachVertex() calls func(t, r) for every rank r, on
+    // thread t, handing out ranks to threads in small batches as they ask
+    // for them, since the amount of work per vertex varies widely.
+    template <typename Func>
+    void Triangles__forEachVertex(int n, unsigned int threads, Func func)
+    {
+        const int batch = 64;
+        std::atomic<int> next{0};
+        runThreads(threads, [&](unsigned int t)
+        {
+            for(int lo = next.fetch_add(batch); lo < n; lo = next.fetch_add(batch))
+                for(int r = lo; r < std::min(n, lo + batch); r++)
+                    func(t, r);
+        });
+    }
+
+
+    inline Triangles__Oriented Triangles__orient(const CSRGraph& g, unsigned int threads)
+    {
+        int n = g.vertexCount();
+        const CSRArray<int>& offsets = g.offsets();
+        const CSRArray<int>& targets = g.targets();
+        CSRGraph transposed = g.transpose();
+        const CSRArray<int>& inOffsets = transposed.offsets();
+        const CSRArray<int>& inSources = transposed.targets();
+
+        // the distinct neighbors of v in either direction, sorted
+        auto neighbors = [&](int v, std::vector<int>& out)
+        {
+            out.assign(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+            out.insert(out.end(), inSources.begin() + inOffsets[v], inSources.begin() + inOffsets[v + 1]);
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+            out.erase(std::remove(out.begin(), out.end(), v), out.end());
+        };
+
+        Triangles__Oriented oriented;
+        oriented.degree.resize(n);
+        runThreads(threads, [&](unsigned int t)
+        {
+            std::vector<int> scratch;
+            for(int v = t; v < n; v += threads)
+            {
+                neighbors(v, scratch);
+                oriented.degree[v] = scratch.size();
+            }
+        });
+
+        oriented.byRank.resize(n);
+        for(int v = 0; v < n; v++)
+            oriented.byRank[v] = v;
+        parallelSort(oriented.byRank.begin(), oriented.byRank.end(), [&](int a, int b)
+        {
+            return oriented.degree[a] != oriented.degree[b] ? oriented.degree[a] < oriented.degree[b] : a < b;
+        }, threads);
+        std::vector<int> rank(n);
+        for(int r = 0; r < n; r++)
+            rank[oriented.byRank[r]] = r;
+
+        // an edge is kept at its lower-ranked end, which has at most as
+        // many neighbors as the other end
+        oriented.offsets.assign(n + 1, 0);
+        runThreads(threads, [&](unsigned int t)
+        {
+            std::vector<int> scratch;
+            for(int v = t; v < n; v += threads)
+            {
+                neighbors(v, scratch);
+                oriented.offsets[rank[v] + 1] = std::count_if(scratch.begin(), scratch.end(),
+                    [&](int w) { return rank[w] > rank[v]; });
+            }
+        });
+        for(int r = 0; r < n; r++)
+            oriented.offsets[r + 1] += oriented.offsets[r];
+
+        oriented.targets.resize(oriented.offsets[n]);
+        runThreads(threads, [&](unsigned int t)
+        {
+            std::vector<int> scratch;
+            for(int v = t; v < n; v += threads)
+            {
+                neighbors(v, scratch);
+                int* out = oriented.targets.data() + oriented.offsets[rank[v]];
+                for(int w : scratch)
+                    if(rank[w] > rank[v])
+                        *out++ = rank[w];
+                std::sort(oriented.targets.data() + oriented.offsets[rank[v]], out);
+            }
+        });
+
+        return oriented;
+    }
+
+
+    // Triangles__intersectionSize() returns the number of elements that
+    // two sorted lists of distinct ints have in common.
+    inline long long Triangles__intersectionSize(const int* a, const int* aEnd, const int* b, const int* bEnd)
+    {
+        long long count = 0;
+
+        // every element of a block that ends no later than the other
+        // block is done with, since everything after the other block is
+        // larger still
+        while(aEnd - a >= 4 && bEnd - b >= 4)
+        {
+            int matches = 0;
+            for(int i = 0; i < 4; i++)
+                for(int j = 0; j < 4; j++)
+                    matches += a[i] == b[j];
+            count += matches;
+
+            int aLast = a[3];
+            int bLast = b[3];
+            if(aLast <= bLast)
+                a += 4;
+            if(bLast <= aLast)
+                b += 4;
+        }
+
+        while(a != aEnd && b != bEnd)
+        {
+            if(*a < *b)
+                a++;
+            else if(*b < *a)
+                b++;
+            else
+            {
+                count++;
+                a++;
+                b++;
+            }
+        }
+        return count;
+    }
+
+
+    // Triangles__localCounts() returns the number of triangles each
+    // vertex belongs to, by dense index.  The lowest-ranked vertex of a
+    // triangle finds it, and credits the other two as well.
+    inline std::vector<long long> Triangles__localCounts(const Triangles__Oriented& oriented, unsigned int threads)
+    {
+        int n = oriented.byRank.size();
+        const std::vector<long long>& offsets = oriented.offsets;
+        const std::vector<int>& targets = oriented.targets;
+
+        std::vector<std::atomic<long long>> counts(n);
+        for(std::atomic<long long>& count : counts)
+            count.store(0, std::memory_order_relaxed);
+
+        Triangles__forEachVertex(n, threads, [&](unsigned int, int u)
+        {
+            long long own = 0;
+            for(long long i = offsets[u]; i < offsets[u + 1]; i++)
+            {
+                int v = targets[i];
+                long long a = i + 1;
+                long long b = offsets[v];
+                long long found = 0;
+                while(a < offsets[u + 1] && b < offsets[v + 1])
+                {
+                    if(targets[a] < targets[b])
+                        a++;
+                    else if(targets[b] < targets[a])
+                        b++;
+                    else
+                    {
+                        counts[targets[a]].fetch_add(1, std::memory_order_relaxed);
+                        found++;
+                        a++;
+                        b++;
+                    }
+                }
+                if(found != 0)
+                    counts[v].fetch_add(found, std::memory_order_relaxed);
+                own += found;
+            }
+            if(own != 0)
+                counts[u].fetch_add(own, std::memory_order_relaxed);
+        });
+
+        std::vector<long long> result(n);
+        for(int r = 0; r < n; r++)
+            result[oriented.byRank[r]] = counts[r].load(std::memory_order_relaxed);
+        return result;
+    }
+}
+
+
+inline long long triangleCount(const CSRGraph& g, unsigned int threads)
+{
+    threads = resolveThreadCount(threads);
+    impl_::Triangles__Oriented oriented = impl_::Triangles__orient(g, threads);
+    const std::vector<long long>& offsets = oriented.offsets;
+    const int* targets = oriented.targets.data();
+
+    std::vector<long long> counts(threads, 0);
+    impl_::Triangles__forEachVertex(g.vertexCount(), threads, [&](unsigned int t, int u)
+    {
+        long long count = 0;
+        for(long long i = offsets[u]; i < offsets[u + 1]; i++)
+        {
+            int v = targets[i];
+            count += impl_::Triangles__intersectionSize(
+                targets + i + 1, targets + offsets[u + 1],
+                targets + offsets[v], targets + offsets[v + 1]);
+        }
+        counts[t] += count;
+    });
+
+    long long total = 0;
+    for(long long count : counts)
+        total += count;
+    return total;
+}
+
+
+inline std::vector<long long> localTriangleCounts(const CSRGraph& g, unsigned int threads)
+{
+    threads = resolveThreadCount(threads);
+    return impl_::Triangles__localCounts(impl_::Triangles__orient(g, threads), threads);
+}
+
+
+inline std::vector<double> localClusteringCoefficients(const CSRGraph& g, unsigned int threads)
+{
+    int n = g.vertexCount();
+    threads = resolveThreadCount(threads);
+    impl_::Triangles__Oriented oriented = impl_::Triangles__orient(g, threads);
+    std::vector<long long> triangles = impl_::Triangles__localCounts(oriented, threads);
+
+    std::vector<double> result(n);
+    for(int v = 0; v < n; v++)
+    {
+        long long degree = oriented.degree[v];
+        result[v] = degree < 2 ? 0.0 : 2.0 * triangles[v] / (degree * (degree - 1));
+    }
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+long long triangleCount(const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads)
+{
+    return triangleCount(CSRGraph{d}, threads);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, double> localClusteringCoefficients(
+    const Digraph<VertexInfo, EdgeInfo>& d, unsigned int threads)
+{
+    CSRGraph g{d};
+    std::vector<double> coefficients = localClusteringCoefficients(g, threads);
+
+    std::map<int, double> ans;
+    for(int i = 0; i < g.vertexCount(); i++)
+        ans.emplace_hint(ans.end(), g.vertexNumber(i), coefficients[i]);
+    return ans;
+}
+
+
+
+#endif // TRIANGLES_HPP